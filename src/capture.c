@@ -62,14 +62,9 @@ capture_init(size_t limit, bool rtp_capture, bool rotate)
     capture_cfg.paused = 0;
     capture_cfg.sources = vector_create(1, 1);
 
-    // Fixme
-    if (setting_has_value(SETTING_CAPTURE_STORAGE, "none")) {
-        capture_cfg.storage = CAPTURE_STORAGE_NONE;
-    } else if (setting_has_value(SETTING_CAPTURE_STORAGE, "memory")) {
-        capture_cfg.storage = CAPTURE_STORAGE_MEMORY;
-    } else if (setting_has_value(SETTING_CAPTURE_STORAGE, "disk")) {
-        capture_cfg.storage = CAPTURE_STORAGE_DISK;
-    }
+    // Set storage mode and keep it updated on setting changes
+    capture_storage_changed(SETTING_CAPTURE_STORAGE, NULL);
+    setting_add_callback(SETTING_CAPTURE_STORAGE, capture_storage_changed, NULL);
 
 #if defined(WITH_GNUTLS) || defined(WITH_OPENSSL)
     // Parse TLS Server setting
@@ -88,6 +83,21 @@ capture_init(size_t limit, bool rtp_capture, bool rotate)
 
 }
 
+void
+capture_storage_changed(int id, void *data)
+{
+    switch (setting_get_enum(id)) {
+        case SETTING_STORAGE_NONE:
+            capture_cfg.storage = CAPTURE_STORAGE_NONE;
+            break;
+        case SETTING_STORAGE_MEMORY:
+            capture_cfg.storage = CAPTURE_STORAGE_MEMORY;
+            break;
+        default:
+            break;
+    }
+}
+
 void
 capture_deinit()
 {
@@ -277,6 +287,7 @@ parse_packet(u_char *info, const struct pcap_pkthdr *header, const u_char *packe
 
         // Remove UDP Header from payload
         size_payload -= udp_off;
+        packet_shift_frames(pkt, 0, -udp_off);
 
         if ((int32_t)size_payload < 0)
             size_payload = 0;
@@ -299,6 +310,7 @@ parse_packet(u_char *info, const struct pcap_pkthdr *header, const u_char *packe
 
         // Get actual payload size
         size_payload -= tcp_off;
+        packet_shift_frames(pkt, 0, -tcp_off);
 
         if ((int32_t)size_payload < 0)
             size_payload = 0;
@@ -340,8 +352,10 @@ parse_packet(u_char *info, const struct pcap_pkthdr *header, const u_char *packe
 #endif
         // Store this packets in output file
         dump_packet(capture_cfg.pd, pkt);
+        // Limit stored SIP payload once it has been exported
+        sip_apply_retention(pkt);
         // If storage is disabled, delete frames payload
-        if (capture_cfg.storage == 0) {
+        if (capture_cfg.storage == CAPTURE_STORAGE_NONE) {
             packet_free_frames(pkt);
         }
         // Allow Interface refresh and user input actions
@@ -485,7 +499,9 @@ capture_packet_reasm_ip(capture_info_t *capinfo, const struct pcap_pkthdr *heade
     if (ip_frag == 0) {
         // Just create a new packet with given network data
         pkt = packet_create(ip_ver, ip_proto, src, dst, ip_id);
-        packet_add_frame(pkt, header, packet);
+        frame = packet_add_frame(pkt, header, packet);
+        frame->payload_hl = link_hl + ip_hl;
+        frame->payload_len = ip_len - ip_hl;
         return pkt;
     }
 
@@ -501,14 +517,19 @@ capture_packet_reasm_ip(capture_info_t *capinfo, const struct pcap_pkthdr *heade
 
     // If we already have this packet stored, append this frames to existing one
     if (pkt) {
-        packet_add_frame(pkt, header, packet);
+        frame = packet_add_frame(pkt, header, packet);
     } else {
         // Add To the possible reassembly list
         pkt = packet_create(ip_ver, ip_proto, src, dst, ip_id);
-        packet_add_frame(pkt, header, packet);
+        frame = packet_add_frame(pkt, header, packet);
         vector_append(capinfo->ip_reasm, pkt);
     }
 
+    // Store which part of IP payload is contained in this frame
+    frame->payload_hl = link_hl + ip_hl;
+    frame->payload_off = ip_frag_off;
+    frame->payload_len = ip_len - ip_hl;
+
     // Add this IP content length to the total captured of the packet
     pkt->ip_cap_len += ip_len - ip_hl;
 
@@ -564,6 +585,8 @@ capture_packet_reasm_tcp(capture_info_t *capinfo, packet_t *packet, struct tcphd
     packet_t *pkt;
     u_char *new_payload;
     u_char full_payload[MAX_CAPTURE_LEN + 1];
+    //! First frame added by this segment
+    int first_frame = 0;
 
     //! Assembled
     if ((int32_t) size_payload <= 0)
@@ -578,11 +601,16 @@ capture_packet_reasm_tcp(capture_info_t *capinfo, packet_t *packet, struct tcphd
 
     // If we already have this packet stored
     if (pkt) {
-        frame_t *frame;
+        frame_t *frame, *pkt_frame;
         // Append this frames to the original packet
+        first_frame = vector_count(pkt->frames);
         vector_iter_t frames = vector_iterator(packet->frames);
-        while ((frame = vector_iterator_next(&frames)))
-            packet_add_frame(pkt, frame->header, frame->data);
+        while ((frame = vector_iterator_next(&frames))) {
+            pkt_frame = packet_add_frame(pkt, frame->header, frame->data);
+            pkt_frame->payload_hl = frame->payload_hl;
+            pkt_frame->payload_off = frame->payload_off;
+            pkt_frame->payload_len = frame->payload_len;
+        }
         // Destroy current packet as its frames belong to the stored packet
         packet_destroy(packet);
     } else {
@@ -614,10 +642,13 @@ capture_packet_reasm_tcp(capture_info_t *capinfo, packet_t *packet, struct tcphd
             pkt->tcp_seq =  ntohl(tcp->th_seq);
             memcpy(new_payload, pkt->payload, pkt->payload_len);
             memcpy(new_payload + pkt->payload_len, payload, size_payload);
+            packet_shift_frames(pkt, first_frame, pkt->payload_len);
         } else {
             // Prepend payload to the existing
             memcpy(new_payload, payload, size_payload);
             memcpy(new_payload + size_payload, pkt->payload, pkt->payload_len);
+            packet_shift_frames(pkt, 0, size_payload);
+            packet_shift_frames(pkt, first_frame, -size_payload);
         }
         packet_set_payload(pkt, new_payload, pkt->payload_len + size_payload);
         sng_free(new_payload);
@@ -640,6 +671,7 @@ capture_packet_reasm_tcp(capture_info_t *capinfo, packet_t *packet, struct tcphd
         // We have a full SIP Packet, but do not remove everything from the reasm queue
         packet_t *cont = packet_clone(pkt);
         int pldiff = original_size - pkt->payload_len;
+        packet_shift_frames(cont, 0, -pkt->payload_len);
         if (pldiff > 0 && pldiff < MAX_CAPTURE_LEN) {
             packet_set_payload(cont, full_payload + pkt->payload_len, pldiff);
             vector_append(capinfo->tcp_reasm, cont);
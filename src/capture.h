@@ -193,6 +193,18 @@ struct capture_info
 void
 capture_init(size_t limit, bool rtp_capture, bool rotate);
 
+/**
+ * @brief Update capture storage mode from its setting
+ *
+ * This function is registered as setting change callback for
+ * capture.storage setting.
+ *
+ * @param id Setting id of changed setting
+ * @param data Unused callback data
+ */
+void
+capture_storage_changed(int id, void *data);
+
 /**
  * @brief Deinitialize capture data
  */
@@ -47,6 +47,8 @@
 #include <unistd.h>
 #include <pcap.h>
 #include "capture_eep.h"
+#include "rtp.h"
+#include "sip.h"
 #include "util.h"
 #include "setting.h"
 
@@ -151,6 +153,9 @@ accept_eep_client(void *data)
             capture_lock();
             if (capture_packet_parse(pkt) != 0) {
                 packet_destroy(pkt);
+            } else {
+                // Limit stored SIP payload once it has been parsed
+                sip_apply_retention(pkt);
             }
             capture_unlock();
         }
@@ -592,129 +597,71 @@ capture_eep_receive_v2()
 packet_t *
 capture_eep_receive_v3()
 {
-
-    struct hep_generic hg;
-    hep_chunk_ip4_t src_ip4, dst_ip4;
-#ifdef USE_IPV6
-    hep_chunk_ip6_t src_ip6, dst_ip6;
-#endif
-    hep_chunk_t payload_chunk;
-    hep_chunk_t authkey_chunk;
-    hep_chunk_t uuid_chunk;
-    uint8_t family, proto;
-    char password[100];
-    int password_len, uuid_len;
-    unsigned char *payload = 0;
-    uint32_t len, pos;
+    hep_info_t info;
+    ssize_t rlen;
     char buffer[MAX_CAPTURE_LEN] ;
-    //! Source and Destination Address
-    address_t src, dst;
     //! EEP client data
     struct sockaddr eep_client;
     socklen_t eep_client_len;
     //! Packet header
-    struct pcap_pkthdr header;
+    struct pcap_pkthdr header = { };
     //! New created packet pointer
     packet_t *pkt;
 
     /* Receive EEP generic header */
-    if (recvfrom(eep_cfg.server_sock, buffer, MAX_CAPTURE_LEN, 0, &eep_client, &eep_client_len) == -1)
+    eep_client_len = sizeof(eep_client);
+    if ((rlen = recvfrom(eep_cfg.server_sock, buffer, MAX_CAPTURE_LEN, 0, &eep_client, &eep_client_len)) == -1)
         return NULL;
 
-    /* Copy initial bytes to EEP Generic header */
-    memcpy(&hg, buffer, sizeof(struct hep_generic));
-
-    /* header check */
-    if (memcmp(hg.header.id, "\x48\x45\x50\x33", 4) != 0)
+    /* Parse all received chunks */
+    if (hep_parse_v3((u_char *) buffer, rlen, eep_cfg.capt_srv_password, &info) != 0)
         return NULL;
 
-    /* IP proto */
-    family = hg.ip_family.data;
-    /* Proto ID */
-    proto = hg.ip_proto.data;
-
-    len = ntohs(hg.header.length) - sizeof(struct hep_generic);
-    pos = sizeof(struct hep_generic);
-
-    /* IPv4 */
-    if (family == AF_INET) {
-        /* SRC IP */
-        memcpy(&src_ip4, (void*) buffer + pos, sizeof(struct hep_chunk_ip4));
-        inet_ntop(AF_INET, &src_ip4.data, src.ip, sizeof(src.ip));
-        pos += sizeof(struct hep_chunk_ip4);
-
-        /* DST IP */
-        memcpy(&dst_ip4, (void*) buffer + pos, sizeof(struct hep_chunk_ip4));
-        inet_ntop(AF_INET, &dst_ip4.data, dst.ip, sizeof(src.ip));
-        pos += sizeof(struct hep_chunk_ip4);
-    }
-#ifdef USE_IPV6
-    /* IPv6 */
-    else if(family == AF_INET6) {
-        /* SRC IPv6 */
-        memcpy(&src_ip6, (void*) buffer + pos, sizeof(struct hep_chunk_ip6));
-        inet_ntop(AF_INET6, &src_ip6.data, src.ip, sizeof(src.ip));
-        pos += sizeof(struct hep_chunk_ip6);
-
-        /* DST IP */
-        memcpy(&src_ip6, (void*) buffer + pos, sizeof(struct hep_chunk_ip6));
-        inet_ntop(AF_INET6, &dst_ip6.data, dst.ip, sizeof(dst.ip));
-        pos += sizeof(struct hep_chunk_ip6);
-    }
-#endif
-
-    /* SRC PORT */
-    src.port = ntohs(hg.src_port.data);
-    /* DST PORT */
-    dst.port = ntohs(hg.dst_port.data);
-    /* TIMESTAMP*/
-    header.ts.tv_sec = ntohl(hg.time_sec.data);
-    header.ts.tv_usec = ntohl(hg.time_usec.data);
-    /* Protocol TYPE */
-    /* Capture ID */
+    header.ts = info.ts;
+    header.caplen = header.len = info.payload_len;
 
-    /* auth key */
-    if (eep_cfg.capt_srv_password != NULL) {
-        memcpy(&authkey_chunk, (void*) buffer + pos, sizeof(authkey_chunk));
-        pos += sizeof(authkey_chunk);
-
-        password_len = ntohs(authkey_chunk.length) - sizeof(authkey_chunk);
-        memcpy(password, (void*) buffer + pos, password_len);
-        pos += password_len;
-
-        // Validate the password
-        if (strncmp(password, eep_cfg.capt_srv_password, password_len) != 0)
-            return NULL;
-    }
-
-    if (setting_enabled(SETTING_EEP_LISTEN_UUID)) {
-        memcpy(&uuid_chunk, (void*) buffer + pos, sizeof(uuid_chunk));
-        pos += sizeof(uuid_chunk);
-
-        uuid_len = ntohs(uuid_chunk.length) - sizeof(uuid_chunk);
-        pos += uuid_len;
+    // Create a new packet
+    pkt = packet_create((info.family == AF_INET)?4:6, info.proto, info.src, info.dst, 0);
+    packet_add_frame(pkt, &header, info.payload);
+    packet_set_transport_data(pkt, info.src.port, info.dst.port);
+
+    switch (info.proto_type) {
+        case HEP_PROTO_SIP:
+            packet_set_type(pkt, PACKET_SIP_UDP);
+            packet_set_payload(pkt, (u_char *) info.payload, info.payload_len);
+            return pkt;
+        case HEP_PROTO_RTCP:
+        case HEP_PROTO_QOS:
+        case HEP_PROTO_RTP_REPORT:
+        case HEP_PROTO_RTCP_XR:
+            packet_set_type(pkt, PACKET_RTCP);
+            packet_set_payload(pkt, (u_char *) info.payload, info.payload_len);
+            capture_eep_receive_report(pkt, info.callid);
+            break;
+        default:
+            break;
     }
 
-    /* Payload */
-    memcpy(&payload_chunk, (void*) buffer + pos, sizeof(payload_chunk));
-    pos += sizeof(payload_chunk);
+    /* FREE */
+    packet_destroy(pkt);
+    return NULL;
+}
 
-    // Calculate payload size
-    header.caplen = header.len = ntohs(payload_chunk.length) - sizeof(payload_chunk);
+int
+capture_eep_receive_report(packet_t *pkt, const char *callid)
+{
+    rtp_stream_t *stream;
 
-    // Receive packet payload
-    payload = sng_malloc(header.caplen);
-    memcpy(payload, (void*) buffer + pos, header.caplen);
+    // Reports without correlation can not be assigned to a dialog
+    if (!strlen(callid))
+        return 1;
 
-    // Create a new packet
-    pkt = packet_create((family == AF_INET)?4:6, proto, src, dst, 0);
-    packet_add_frame(pkt, &header, payload);
-    packet_set_type(pkt, PACKET_SIP_UDP);
-    packet_set_payload(pkt, payload, header.caplen);
+    // Avoid parsing while screen in being redrawn
+    capture_lock();
+    stream = rtp_check_report(pkt, callid);
+    capture_unlock();
 
-    /* FREE */
-    sng_free(payload);
-    return pkt;
+    return (stream) ? 0 : 1;
 }
 
 int
@@ -43,6 +43,7 @@
 #define __SNGREP_CAPTURE_EEP_H
 #include <pthread.h>
 #include "capture.h"
+#include "hep.h"
 
 //! Shorter declaration of capture_eep_config structure
 typedef struct capture_eep_config  capture_eep_config_t;
@@ -305,11 +306,28 @@ capture_eep_receive_v2();
  * function will parse received EEP data and create a new packet
  * structure.
  *
- * @return NULL on any error, packet structure otherwise
+ * RTCP and QoS reports are not returned as packets, they are
+ * processed by capture_eep_receive_report instead.
+ *
+ * @return NULL on any error or report, packet structure otherwise
  */
 packet_t *
 capture_eep_receive_v3();
 
+/**
+ * @brief Process a received RTCP or QoS report (EEP version 3)
+ *
+ * Reports are correlated to their dialogs using the HEP correlation
+ * chunk (Call-ID) and used to fill the stream quality information,
+ * so there is no need to capture every RTP packet.
+ *
+ * @param pkt Packet with the report payload
+ * @param callid Correlation identifier of the report
+ * @return 0 if report has been processed, 1 otherwise
+ */
+int
+capture_eep_receive_report(packet_t *pkt, const char *callid);
+
 /**
  * @brief Set EEP server url
  *
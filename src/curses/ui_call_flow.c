@@ -183,11 +183,11 @@ call_flow_draw(ui_t *ui)
     }
 
     // Print color mode in title
-    if (setting_has_value(SETTING_COLORMODE, "request"))
+    if (setting_get_enum(SETTING_COLORMODE) == SETTING_COLORMODE_REQUEST)
         strcat(title, " (Color by Request/Response)");
-    if (setting_has_value(SETTING_COLORMODE, "callid"))
+    if (setting_get_enum(SETTING_COLORMODE) == SETTING_COLORMODE_CALLID)
         strcat(title, " (Color by Call-Id)");
-    if (setting_has_value(SETTING_COLORMODE, "cseq"))
+    if (setting_get_enum(SETTING_COLORMODE) == SETTING_COLORMODE_CSEQ)
         strcat(title, " (Color by CSeq)");
 
     // Draw panel title
@@ -457,13 +457,13 @@ call_flow_draw_message(ui_t *ui, call_flow_arrow_t *arrow, int cline)
     sprintf(method, "%s", msg_method);
 
     // If message has sdp information
-    if (msg_has_sdp(msg) && setting_has_value(SETTING_CF_SDP_INFO, "off")) {
+    if (msg_has_sdp(msg) && setting_get_enum(SETTING_CF_SDP_INFO) == SETTING_SDP_OFF) {
         // Show sdp tag in title
         sprintf(method, "%s (SDP)", msg_method);
     }
 
     // If message has sdp information
-    if (setting_has_value(SETTING_CF_SDP_INFO, "compressed")) {
+    if (setting_get_enum(SETTING_CF_SDP_INFO) == SETTING_SDP_COMPRESSED) {
         // Show sdp tag in title
         if (msg_has_sdp(msg)) {
             sprintf(method, "%.*s (SDP)", 12, msg_method);
@@ -472,14 +472,14 @@ call_flow_draw_message(ui_t *ui, call_flow_arrow_t *arrow, int cline)
         }
     }
 
-    if (msg_has_sdp(msg) && setting_has_value(SETTING_CF_SDP_INFO, "first")) {
+    if (msg_has_sdp(msg) && setting_get_enum(SETTING_CF_SDP_INFO) == SETTING_SDP_FIRST) {
         sprintf(method, "%.3s (%s:%u)",
                 msg_method,
                 media->address.ip,
                 media->address.port);
     }
 
-    if (msg_has_sdp(msg) && setting_has_value(SETTING_CF_SDP_INFO, "full")) {
+    if (msg_has_sdp(msg) && setting_get_enum(SETTING_CF_SDP_INFO) == SETTING_SDP_FULL) {
         sprintf(method, "%.3s (%s)", msg_method, media->address.ip);
     }
 
@@ -505,26 +505,26 @@ call_flow_draw_message(ui_t *ui, call_flow_arrow_t *arrow, int cline)
 
     // Highlight current message
     if (arrow == vector_item(info->darrows, info->cur_arrow)) {
-        if (setting_has_value(SETTING_CF_HIGHTLIGHT, "reverse")) {
+        if (setting_get_enum(SETTING_CF_HIGHTLIGHT) == SETTING_HIGHLIGHT_REVERSE) {
             wattron(flow_win, A_REVERSE);
         }
-        if (setting_has_value(SETTING_CF_HIGHTLIGHT, "bold")) {
+        if (setting_get_enum(SETTING_CF_HIGHTLIGHT) == SETTING_HIGHLIGHT_BOLD) {
             wattron(flow_win, A_BOLD);
         }
-        if (setting_has_value(SETTING_CF_HIGHTLIGHT, "reversebold")) {
+        if (setting_get_enum(SETTING_CF_HIGHTLIGHT) == SETTING_HIGHLIGHT_REVERSEBOLD) {
             wattron(flow_win, A_REVERSE);
             wattron(flow_win, A_BOLD);
         }
     }
 
     // Color the message {
-    if (setting_has_value(SETTING_COLORMODE, "request")) {
+    if (setting_get_enum(SETTING_COLORMODE) == SETTING_COLORMODE_REQUEST) {
         // Color by request / response
         color = (msg_is_request(msg)) ? CP_RED_ON_DEF : CP_GREEN_ON_DEF;
-    } else if (setting_has_value(SETTING_COLORMODE, "callid")) {
+    } else if (setting_get_enum(SETTING_COLORMODE) == SETTING_COLORMODE_CALLID) {
         // Color by call-id
         color = call_group_color(info->group, msg->call);
-    } else if (setting_has_value(SETTING_COLORMODE, "cseq")) {
+    } else if (setting_get_enum(SETTING_COLORMODE) == SETTING_COLORMODE_CSEQ) {
         // Color by CSeq within the same call
         color = msg->cseq % 7 + 1;
     }
@@ -537,11 +537,11 @@ call_flow_draw_message(ui_t *ui, call_flow_arrow_t *arrow, int cline)
     // Draw method
     mvwprintw(flow_win, cline, startpos + distance / 2 - msglen / 2 + 2, "%.26s", method);
 
-    if (!setting_has_value(SETTING_CF_SDP_INFO, "compressed"))
+    if (setting_get_enum(SETTING_CF_SDP_INFO) != SETTING_SDP_COMPRESSED)
         cline++;
 
     // Draw media information
-    if (msg_has_sdp(msg) && setting_has_value(SETTING_CF_SDP_INFO, "full")) {
+    if (msg_has_sdp(msg) && setting_get_enum(SETTING_CF_SDP_INFO) == SETTING_SDP_FULL) {
         medias = vector_iterator(msg->medias);
         while ((media = vector_iterator_next(&medias))) {
             sprintf(mediastr, "%s %d (%s)",
@@ -573,7 +573,7 @@ call_flow_draw_message(ui_t *ui, call_flow_arrow_t *arrow, int cline)
         }
     }
 
-    if (setting_has_value(SETTING_CF_SDP_INFO, "compressed"))
+    if (setting_get_enum(SETTING_CF_SDP_INFO) == SETTING_SDP_COMPRESSED)
         mvwprintw(flow_win, cline, startpos + distance / 2 - msglen / 2 + 2, " %.26s ", method);
 
     // Turn off colors
@@ -597,7 +597,7 @@ call_flow_draw_message(ui_t *ui, call_flow_arrow_t *arrow, int cline)
         }
 
         // Print delta from selected message
-        if (!setting_has_value(SETTING_CF_SDP_INFO, "compressed")) {
+        if (setting_get_enum(SETTING_CF_SDP_INFO) != SETTING_SDP_COMPRESSED) {
             if (info->selected == -1) {
                 if (setting_enabled(SETTING_CF_DELTA)) {
                     struct timeval selts, curts;
@@ -739,7 +739,7 @@ call_flow_draw_rtp_stream(ui_t *ui, call_flow_arrow_t *arrow, int cline)
     if (startpos != endpos) {
         // In compressed mode, we display the src and dst port inside the arrow
         // so fixup the stard and end position
-        if (!setting_has_value(SETTING_CF_SDP_INFO, "compressed")) {
+        if (setting_get_enum(SETTING_CF_SDP_INFO) != SETTING_SDP_COMPRESSED) {
             startpos += 5;
             endpos -= 5;
         }
@@ -760,13 +760,13 @@ call_flow_draw_rtp_stream(ui_t *ui, call_flow_arrow_t *arrow, int cline)
 
     // Highlight current message
     if (arrow == vector_item(info->darrows, info->cur_arrow)) {
-        if (setting_has_value(SETTING_CF_HIGHTLIGHT, "reverse")) {
+        if (setting_get_enum(SETTING_CF_HIGHTLIGHT) == SETTING_HIGHLIGHT_REVERSE) {
             wattron(win, A_REVERSE);
         }
-        if (setting_has_value(SETTING_CF_HIGHTLIGHT, "bold")) {
+        if (setting_get_enum(SETTING_CF_HIGHTLIGHT) == SETTING_HIGHLIGHT_BOLD) {
             wattron(win, A_BOLD);
         }
-        if (setting_has_value(SETTING_CF_HIGHTLIGHT, "reversebold")) {
+        if (setting_get_enum(SETTING_CF_HIGHTLIGHT) == SETTING_HIGHLIGHT_REVERSEBOLD) {
             wattron(win, A_REVERSE);
             wattron(win, A_BOLD);
         }
@@ -780,7 +780,7 @@ call_flow_draw_rtp_stream(ui_t *ui, call_flow_arrow_t *arrow, int cline)
     // Draw RTP arrow text
     mvwprintw(win, cline, startpos + (distance) / 2 - strlen(text) / 2 + 2, "%s", text);
 
-    if (!setting_has_value(SETTING_CF_SDP_INFO, "compressed"))
+    if (setting_get_enum(SETTING_CF_SDP_INFO) != SETTING_SDP_COMPRESSED)
         cline++;
 
     // Draw line between columns
@@ -791,7 +791,7 @@ call_flow_draw_rtp_stream(ui_t *ui, call_flow_arrow_t *arrow, int cline)
 
     // Write the arrow at the end of the message (two arrows if this is a retrans)
     if (arrow_dir == CF_ARROW_RIGHT) {
-        if (!setting_has_value(SETTING_CF_SDP_INFO, "compressed")) {
+        if (setting_get_enum(SETTING_CF_SDP_INFO) != SETTING_SDP_COMPRESSED) {
             mvwprintw(win, cline, startpos - 4, "%d", stream->src.port);
             mvwprintw(win, cline, endpos, "%d", stream->dst.port);
         }
@@ -802,7 +802,7 @@ call_flow_draw_rtp_stream(ui_t *ui, call_flow_arrow_t *arrow, int cline)
             mvwaddch(win, cline, startpos + arrow->rtp_ind_pos + 2, '>');
         }
     } else {
-        if (!setting_has_value(SETTING_CF_SDP_INFO, "compressed")) {
+        if (setting_get_enum(SETTING_CF_SDP_INFO) != SETTING_SDP_COMPRESSED) {
             mvwprintw(win, cline, endpos, "%d", stream->src.port);
             mvwprintw(win, cline, startpos - 4, "%d", stream->dst.port);
         }
@@ -814,7 +814,7 @@ call_flow_draw_rtp_stream(ui_t *ui, call_flow_arrow_t *arrow, int cline)
         }
     }
 
-    if (setting_has_value(SETTING_CF_SDP_INFO, "compressed"))
+    if (setting_get_enum(SETTING_CF_SDP_INFO) == SETTING_SDP_COMPRESSED)
         mvwprintw(win, cline, startpos + (distance) / 2 - strlen(text) / 2 + 2, " %s ", text);
 
     wattroff(win, A_BOLD | A_REVERSE);
@@ -861,18 +861,18 @@ call_flow_arrow_height(ui_t *ui, const call_flow_arrow_t *arrow)
     if (arrow->type == CF_ARROW_SIP) {
         if (setting_enabled(SETTING_CF_ONLYMEDIA))
             return 0;
-        if (setting_has_value(SETTING_CF_SDP_INFO, "compressed"))
+        if (setting_get_enum(SETTING_CF_SDP_INFO) == SETTING_SDP_COMPRESSED)
             return 1;
         if (!msg_has_sdp(arrow->item))
             return 2;
-        if (setting_has_value(SETTING_CF_SDP_INFO, "off"))
+        if (setting_get_enum(SETTING_CF_SDP_INFO) == SETTING_SDP_OFF)
             return 2;
-        if (setting_has_value(SETTING_CF_SDP_INFO, "first"))
+        if (setting_get_enum(SETTING_CF_SDP_INFO) == SETTING_SDP_FIRST)
             return 2;
-        if (setting_has_value(SETTING_CF_SDP_INFO, "full"))
+        if (setting_get_enum(SETTING_CF_SDP_INFO) == SETTING_SDP_FULL)
             return msg_media_count(arrow->item) + 2;
     } else if (arrow->type == CF_ARROW_RTP || arrow->type == CF_ARROW_RTCP) {
-        if (setting_has_value(SETTING_CF_SDP_INFO, "compressed"))
+        if (setting_get_enum(SETTING_CF_SDP_INFO) == SETTING_SDP_COMPRESSED)
             return 1;
         if (setting_disabled(SETTING_CF_MEDIA))
             return 0;
@@ -1044,8 +1044,10 @@ call_flow_draw_raw_rtcp(ui_t *ui, rtp_stream_t *stream)
     mvwprintw(raw_win, 2, 0, "Sender's packet count: %d", stream->rtcpinfo.spc);
     mvwprintw(raw_win, 3, 0, "Fraction Lost: %d / 256", stream->rtcpinfo.flost);
     mvwprintw(raw_win, 4, 0, "Fraction discarded: %d / 256", stream->rtcpinfo.fdiscard);
-    mvwprintw(raw_win, 6, 0, "MOS - Listening Quality: %.1f", (float) stream->rtcpinfo.mosl / 10);
-    mvwprintw(raw_win, 7, 0, "MOS - Conversational Quality: %.1f", (float) stream->rtcpinfo.mosc / 10);
+    mvwprintw(raw_win, 5, 0, "Packets lost: %u", stream->rtcpinfo.plost);
+    mvwprintw(raw_win, 6, 0, "Interarrival jitter: %u", stream->rtcpinfo.jitter);
+    mvwprintw(raw_win, 8, 0, "MOS - Listening Quality: %.1f", (float) stream->rtcpinfo.mosl / 10);
+    mvwprintw(raw_win, 9, 0, "MOS - Conversational Quality: %.1f", (float) stream->rtcpinfo.mosc / 10);
 
 
 
@@ -1530,7 +1532,7 @@ call_flow_arrow_filter(void *item)
         if (setting_enabled(SETTING_CF_MEDIA))
             return 1;
         // Otherwise only show active streams
-        if (setting_has_value(SETTING_CF_MEDIA, SETTING_ACTIVE))
+        if (setting_get_enum(SETTING_CF_MEDIA) == SETTING_MEDIA_ACTIVE)
             return stream_is_active(arrow->item);
     }
 
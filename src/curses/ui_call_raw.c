@@ -169,17 +169,17 @@ call_raw_print_msg(ui_t *ui, sip_msg_t *msg)
     }
 
     // Color the message {
-    if (setting_has_value(SETTING_COLORMODE, "request")) {
+    if (setting_get_enum(SETTING_COLORMODE) == SETTING_COLORMODE_REQUEST) {
         // Determine arrow color
         if (msg_is_request(msg)) {
             color = CP_RED_ON_DEF;
         } else {
             color = CP_GREEN_ON_DEF;
         }
-    } else if (info->group && setting_has_value(SETTING_COLORMODE, "callid")) {
+    } else if (info->group && setting_get_enum(SETTING_COLORMODE) == SETTING_COLORMODE_CALLID) {
         // Color by call-id
         color = call_group_color(info->group, msg->call);
-    } else if (setting_has_value(SETTING_COLORMODE, "cseq")) {
+    } else if (setting_get_enum(SETTING_COLORMODE) == SETTING_COLORMODE_CSEQ) {
         // Color by CSeq within the same call
         color = msg->cseq % 7 + 1;
     }
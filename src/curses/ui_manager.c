@@ -467,6 +467,15 @@ draw_message_pos(WINDOW *win, sip_msg_t *msg, int starting)
     if (syntax)
         wattroff(win, attrs);
 
+    // Mark payload bytes not stored by retention policy
+    if (msg->packet->payload_trunc && line < height) {
+        if (column)
+            line++;
+        wattron(win, A_BOLD | COLOR_PAIR(CP_YELLOW_ON_DEF));
+        mvwprintw(win, line++, 0, "[... %u bytes not stored]", msg->packet->payload_trunc);
+        wattroff(win, A_BOLD | COLOR_PAIR(CP_YELLOW_ON_DEF));
+    }
+
     // Redraw raw win
     wnoutrefresh(win);
 
@@ -80,6 +80,10 @@ enum settings_field_list {
     FLD_SETTINGS_SIP_NOINCOMPLETE_LB,
     FLD_SETTINGS_SAVEPATH,
     FLD_SETTINGS_SAVEPATH_LB,
+    FLD_SETTINGS_SIP_RETENTION,
+    FLD_SETTINGS_SIP_RETENTION_LB,
+    FLD_SETTINGS_SIP_RETENTION_MAXBODY,
+    FLD_SETTINGS_SIP_RETENTION_MAXBODY_LB,
     FLD_SETTINGS_CF_FORCERAW,
     FLD_SETTINGS_CF_FORCERAW_LB,
     FLD_SETTINGS_CF_SPLITCACALLID,
@@ -119,8 +123,6 @@ enum settings_field_list {
     FLD_SETTINGS_EEP_LISTEN_PORT_LB,
     FLD_SETTINGS_EEP_LISTEN_PASS,
     FLD_SETTINGS_EEP_LISTEN_PASS_LB,
-	FLD_SETTINGS_EEP_LISTEN_UUID,
-	FLD_SETTINGS_EEP_LISTEN_UUID_LB,
 #endif
     FLD_SETTINGS_COUNT,
 };
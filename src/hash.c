@@ -57,6 +57,17 @@ htable_create(size_t size)
 void
 htable_destroy(htable_t *table)
 {
+    size_t pos;
+    hentry_t *entry, *next;
+
+    // Remove all bucket entries
+    for (pos = 0; pos < table->size; pos++) {
+        for (entry = table->buckets[pos]; entry; entry = next) {
+            next = entry->next;
+            free(entry);
+        }
+    }
+
     free(table->buckets);
     free(table);
 }
@@ -107,6 +118,7 @@ htable_remove(htable_t *table, const char *key)
             }
             // Remove item memory
             free(entry);
+            return;
         }
     }
 }
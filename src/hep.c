@@ -0,0 +1,217 @@
+/**************************************************************************
+ **
+ ** sngrep - SIP Messages flow viewer
+ **
+ ** Copyright (C) 2013-2018 Ivan Alonso (Kaian)
+ ** Copyright (C) 2013-2018 Irontec SL. All rights reserved.
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ ****************************************************************************/
+/**
+ * @file hep.c
+ * @author Ivan Alonso [aka Kaian] <kaian@irontec.com>
+ *
+ * @brief Source code of functions defined in hep.h
+ *
+ */
+#include "hep.h"
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+int
+hep_parse_v3(const u_char *buffer, uint32_t size, const char *password, hep_info_t *info)
+{
+    uint16_t vendor_id, chunk_type, chunk_len, data_len;
+    uint16_t data16;
+    uint32_t data32;
+    uint32_t len, pos;
+    char key[100];
+    int authenticated = 0;
+    uint8_t family = 0;
+
+    memset(info, 0, sizeof(hep_info_t));
+    info->proto_type = HEP_PROTO_SIP;
+
+    // Check we have at least HEP control header (id + length)
+    if (size < 6 || memcmp(buffer, "\x48\x45\x50\x33", 4) != 0)
+        return 1;
+
+    memcpy(&data16, buffer + 4, sizeof(data16));
+    len = ntohs(data16);
+    if (len > size)
+        len = size;
+    pos = 6;
+
+    // Parse all chunks, they can be received in any order
+    while (pos + 6 <= len) {
+        memcpy(&vendor_id, buffer + pos, sizeof(vendor_id));
+        memcpy(&chunk_type, buffer + pos + 2, sizeof(chunk_type));
+        memcpy(&chunk_len, buffer + pos + 4, sizeof(chunk_len));
+        vendor_id = ntohs(vendor_id);
+        chunk_type = ntohs(chunk_type);
+        chunk_len = ntohs(chunk_len);
+
+        // Check chunk fits in received data
+        if (chunk_len < 6 || pos + chunk_len > len)
+            return 1;
+
+        data_len = chunk_len - 6;
+
+        // Only generic chunks are handled
+        if (vendor_id != 0x0000) {
+            pos += chunk_len;
+            continue;
+        }
+
+        switch (chunk_type) {
+            case HEP_CHUNK_IP_PROTO:
+                if (data_len == 1)
+                    info->proto = buffer[pos + 6];
+                break;
+            case HEP_CHUNK_PROTO_TYPE:
+                if (data_len == 1)
+                    info->proto_type = buffer[pos + 6];
+                break;
+            case HEP_CHUNK_IP4_SRC:
+            case HEP_CHUNK_IP4_DST:
+                if (data_len != 4)
+                    break;
+                // Both addresses must have the same family
+                if (family == AF_INET6)
+                    return 1;
+                family = AF_INET;
+                inet_ntop(AF_INET, buffer + pos + 6,
+                          (chunk_type == HEP_CHUNK_IP4_SRC) ? info->src.ip : info->dst.ip, ADDRESSLEN);
+                break;
+#ifdef USE_IPV6
+            case HEP_CHUNK_IP6_SRC:
+            case HEP_CHUNK_IP6_DST:
+                if (data_len != 16)
+                    break;
+                // Both addresses must have the same family
+                if (family == AF_INET)
+                    return 1;
+                family = AF_INET6;
+                inet_ntop(AF_INET6, buffer + pos + 6,
+                          (chunk_type == HEP_CHUNK_IP6_SRC) ? info->src.ip : info->dst.ip, ADDRESSLEN);
+                break;
+#endif
+            case HEP_CHUNK_SRC_PORT:
+                if (data_len == 2) {
+                    memcpy(&data16, buffer + pos + 6, sizeof(data16));
+                    info->src.port = ntohs(data16);
+                }
+                break;
+            case HEP_CHUNK_DST_PORT:
+                if (data_len == 2) {
+                    memcpy(&data16, buffer + pos + 6, sizeof(data16));
+                    info->dst.port = ntohs(data16);
+                }
+                break;
+            case HEP_CHUNK_TIME_SEC:
+                if (data_len == 4) {
+                    memcpy(&data32, buffer + pos + 6, sizeof(data32));
+                    info->ts.tv_sec = ntohl(data32);
+                }
+                break;
+            case HEP_CHUNK_TIME_USEC:
+                if (data_len == 4) {
+                    memcpy(&data32, buffer + pos + 6, sizeof(data32));
+                    info->ts.tv_usec = ntohl(data32);
+                }
+                break;
+            case HEP_CHUNK_AUTH_KEY:
+                // Key is ignored if no password is configured
+                if (password == NULL)
+                    break;
+
+                // Validate the password
+                if (data_len >= sizeof(key))
+                    return 1;
+                memcpy(key, buffer + pos + 6, data_len);
+                key[data_len] = '\0';
+                if (strcmp(key, password) != 0)
+                    return 1;
+                authenticated = 1;
+                break;
+            case HEP_CHUNK_PAYLOAD:
+                info->payload = buffer + pos + 6;
+                info->payload_len = data_len;
+                break;
+            case HEP_CHUNK_CORRELATION_ID:
+                if (data_len >= sizeof(info->callid))
+                    data_len = sizeof(info->callid) - 1;
+                memcpy(info->callid, buffer + pos + 6, data_len);
+                info->callid[data_len] = '\0';
+                break;
+            default:
+                // Not handled chunk (ip family, capture id, uuid, vlan, ...)
+                break;
+        }
+
+        pos += chunk_len;
+    }
+
+    // Check packet has been authenticated
+    if (password != NULL && !authenticated)
+        return 1;
+
+    // Nothing to parse without payload
+    if (!info->payload || !info->payload_len)
+        return 1;
+
+    // IP family is taken from received addresses, not from family chunk
+    if (!family)
+        return 1;
+    info->family = family;
+
+    return 0;
+}
+
+int
+hep_report_value(const char *report, const char *key, double *value)
+{
+    const char *pos, *end;
+    size_t keylen = strlen(key);
+    char *valend;
+
+    for (pos = strcasestr(report, key); pos; pos = strcasestr(pos + 1, key)) {
+        // Key must not be part of a longer name
+        if (pos != report && (isalnum(pos[-1]) || pos[-1] == '_'))
+            continue;
+        end = pos + keylen;
+        if (isalnum(*end) || *end == '_')
+            continue;
+
+        // Skip key closing quote and separator
+        if (*end == '"')
+            end++;
+        while (*end == ' ')
+            end++;
+        if (*end != ':' && *end != '=')
+            continue;
+        end++;
+
+        // Parse the value
+        *value = strtod(end, &valend);
+        if (valend != end)
+            return 0;
+    }
+
+    return 1;
+}
@@ -0,0 +1,130 @@
+/**************************************************************************
+ **
+ ** sngrep - SIP Messages flow viewer
+ **
+ ** Copyright (C) 2013-2018 Ivan Alonso (Kaian)
+ ** Copyright (C) 2013-2018 Irontec SL. All rights reserved.
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ ****************************************************************************/
+/**
+ * @file hep.h
+ * @author Ivan Alonso [aka Kaian] <kaian@irontec.com>
+ *
+ * @brief Functions to parse HEP-EEP received data
+ *
+ * This file contains the parsers of data received through HEPv3 that
+ * don't depend on capture state, so they can be also used from tests.
+ *
+ * Additional information about HEP-EEP protocol can be found in sipcature
+ * repositories at https://github.com/sipcapture/HEP
+ */
+#ifndef __SNGREP_HEP_H
+#define __SNGREP_HEP_H
+
+#include "config.h"
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include "address.h"
+#include "sip_attr.h"
+
+//! Shorter declaration of hep_info structure
+typedef struct hep_info hep_info_t;
+
+//! HEPv3 chunk types (vendor 0x0000)
+enum hep_chunk_type
+{
+    HEP_CHUNK_IP_FAMILY = 0x0001,
+    HEP_CHUNK_IP_PROTO = 0x0002,
+    HEP_CHUNK_IP4_SRC = 0x0003,
+    HEP_CHUNK_IP4_DST = 0x0004,
+    HEP_CHUNK_IP6_SRC = 0x0005,
+    HEP_CHUNK_IP6_DST = 0x0006,
+    HEP_CHUNK_SRC_PORT = 0x0007,
+    HEP_CHUNK_DST_PORT = 0x0008,
+    HEP_CHUNK_TIME_SEC = 0x0009,
+    HEP_CHUNK_TIME_USEC = 0x000a,
+    HEP_CHUNK_PROTO_TYPE = 0x000b,
+    HEP_CHUNK_CAPT_ID = 0x000c,
+    HEP_CHUNK_AUTH_KEY = 0x000e,
+    HEP_CHUNK_PAYLOAD = 0x000f,
+    HEP_CHUNK_CORRELATION_ID = 0x0011,
+};
+
+//! HEPv3 payload protocol types (HEP_CHUNK_PROTO_TYPE values)
+enum hep_proto_type
+{
+    HEP_PROTO_SIP = 0x01,
+    HEP_PROTO_RTCP = 0x05,
+    HEP_PROTO_QOS = 0x20,
+    HEP_PROTO_RTP_REPORT = 0x22,
+    HEP_PROTO_RTCP_XR = 0x23,
+};
+
+/**
+ * @brief Information parsed from a HEPv3 packet
+ */
+struct hep_info
+{
+    //! IP family of addresses (AF_INET or AF_INET6)
+    uint8_t family;
+    //! IP protocol
+    uint8_t proto;
+    //! Payload protocol type (hep_proto_type)
+    uint8_t proto_type;
+    //! Source and Destination Address
+    address_t src, dst;
+    //! Capture timestamp
+    struct timeval ts;
+    //! Payload data (pointer to received buffer)
+    const u_char *payload;
+    //! Payload length
+    uint32_t payload_len;
+    //! Correlation identifier (Call-ID of reports)
+    char callid[SIP_ATTR_MAXLEN];
+};
+
+/**
+ * @brief Parse a received HEPv3 packet
+ *
+ * Chunks can be received in any order. Chunks with fixed size types
+ * that don't match their expected length are ignored. IP family is
+ * taken from the received address chunks, packets without addresses
+ * or mixing IPv4 and IPv6 addresses are rejected.
+ *
+ * @param buffer Received data
+ * @param size Received data length
+ * @param password Required authentication key or NULL
+ * @param info Structure to fill with parsed information
+ * @return 0 if packet is valid, 1 otherwise
+ */
+int
+hep_parse_v3(const u_char *buffer, uint32_t size, const char *password, hep_info_t *info);
+
+/**
+ * @brief Get a numeric value from a quality report
+ *
+ * Quality reports can be either JSON ("key": value) or key=value lists.
+ *
+ * @param report NULL terminated report text
+ * @param key Name of the value (case insensitive)
+ * @param value Pointer to store the parsed value
+ * @return 0 if the value has been found, 1 otherwise
+ */
+int
+hep_report_value(const char *report, const char *key, double *value);
+
+#endif /* __SNGREP_HEP_H */
@@ -54,6 +54,9 @@ init_options(int no_config)
     char *rcfile;
     char pwd[MAX_SETTING_LEN];
 
+    // Parse default settings values
+    settings_init();
+
     // Defualt savepath is current directory
     if (getcwd(pwd, MAX_SETTING_LEN)) {
         setting_set_value(SETTING_SAVEPATH, pwd);
@@ -51,7 +51,7 @@ packet_t*
 packet_clone(packet_t *packet)
 {
     packet_t *clone;
-    frame_t *frame;
+    frame_t *frame, *clone_frame;
 
     // Create a new packet with the original information
     clone =    packet_create(packet->ip_version, packet->proto, packet->src, packet->dst, packet->ip_id);
@@ -59,8 +59,12 @@ packet_clone(packet_t *packet)
 
     // Append this frames to the original packet
     vector_iter_t frames = vector_iterator(packet->frames);
-    while ((frame = vector_iterator_next(&frames)))
-        packet_add_frame(clone, frame->header, frame->data);
+    while ((frame = vector_iterator_next(&frames))) {
+        clone_frame = packet_add_frame(clone, frame->header, frame->data);
+        clone_frame->payload_hl = frame->payload_hl;
+        clone_frame->payload_off = frame->payload_off;
+        clone_frame->payload_len = frame->payload_len;
+    }
 
     return clone;
 }
@@ -121,10 +125,25 @@ packet_add_frame(packet_t *pkt, const struct pcap_pkthdr *header, const u_char *
     memcpy(frame->header, header, sizeof(struct pcap_pkthdr));
     frame->data = malloc(header->caplen);
     memcpy(frame->data, packet, header->caplen);
+    frame->payload_hl = 0;
+    frame->payload_off = 0;
+    frame->payload_len = header->caplen;
     vector_append(pkt->frames, frame);
     return frame;
 }
 
+void
+packet_shift_frames(packet_t *packet, int first, int32_t offset)
+{
+    frame_t *frame;
+    int i;
+
+    for (i = first; i < vector_count(packet->frames); i++) {
+        frame = vector_item(packet->frames, i);
+        frame->payload_off += offset;
+    }
+}
+
 void
 packet_set_type(packet_t *packet, enum packet_type type)
 {
@@ -138,6 +157,7 @@ packet_set_payload(packet_t *packet, u_char *payload, uint32_t payload_len)
     if (packet->payload)
         free(packet->payload);
     packet->payload_len = 0;
+    packet->payload_trunc = 0;
 
     // Set new payload
     if (payload) {
@@ -148,6 +168,81 @@ packet_set_payload(packet_t *packet, u_char *payload, uint32_t payload_len)
     }
 }
 
+void
+packet_truncate_payload(packet_t *packet, uint32_t payload_len)
+{
+    uint32_t removed;
+
+    // Nothing to truncate
+    if (!packet->payload || payload_len >= packet->payload_len)
+        return;
+
+    removed = packet->payload_len - payload_len;
+
+    // Remove truncated bytes from payload
+    packet->payload = realloc(packet->payload, payload_len + 1);
+    packet->payload[payload_len] = '\0';
+    packet->payload_len = payload_len;
+    packet->payload_trunc += removed;
+
+    // Remove truncated bytes from captured data
+    packet_truncate_frames(packet, payload_len);
+}
+
+void
+packet_strip_payload(packet_t *packet, uint32_t offset, uint32_t len)
+{
+    // Nothing to remove
+    if (!packet->payload || offset >= packet->payload_len)
+        return;
+
+    if (len > packet->payload_len - offset)
+        len = packet->payload_len - offset;
+    if (!len)
+        return;
+
+    // Move the following payload bytes over the removed ones
+    memmove(packet->payload + offset, packet->payload + offset + len,
+            packet->payload_len - offset - len);
+    packet->payload_len -= len;
+    packet->payload = realloc(packet->payload, packet->payload_len + 1);
+    packet->payload[packet->payload_len] = '\0';
+    packet->payload_trunc += len;
+
+    // Captured data can only be stored until the first removed byte
+    packet_truncate_frames(packet, offset);
+}
+
+void
+packet_truncate_frames(packet_t *packet, uint32_t payload_len)
+{
+    frame_t *frame;
+    vector_iter_t it;
+    uint32_t caplen;
+    int64_t keep;
+
+    // Only UDP and TCP frames contain the packet payload as is
+    if (packet->type != PACKET_SIP_UDP && packet->type != PACKET_SIP_TCP)
+        return;
+
+    // Remove truncated bytes from captured data (keeping original length)
+    it = vector_iterator(packet->frames);
+    while ((frame = vector_iterator_next(&it))) {
+        // Payload bytes of this frame that are still stored
+        keep = (int64_t) payload_len - frame->payload_off;
+        if (keep < 0)
+            keep = 0;
+        if (keep > frame->payload_len)
+            keep = frame->payload_len;
+
+        caplen = frame->payload_hl + keep;
+        if (frame->data && caplen && caplen < frame->header->caplen) {
+            frame->header->caplen = caplen;
+            frame->data = realloc(frame->data, caplen);
+        }
+    }
+}
+
 uint32_t
 packet_payloadlen(packet_t *packet)
 {
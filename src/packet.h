@@ -88,6 +88,8 @@ struct packet {
     u_char *payload;
     //! Payload length
     uint32_t payload_len;
+    //! Payload bytes removed by retention policy
+    uint32_t payload_trunc;
     //! Packet frame list (frame_t)
     vector_t *frames;
 };
@@ -103,6 +105,12 @@ struct frame {
     struct pcap_pkthdr *header;
     //! PCAP Frame content
     u_char *data;
+    //! Frame headers length before its payload data
+    uint32_t payload_hl;
+    //! Offset of frame payload data in packet payload (negative for transport headers)
+    int32_t payload_off;
+    //! Frame payload data length
+    uint32_t payload_len;
 };
 
 /**
@@ -125,10 +133,25 @@ packet_set_transport_data(packet_t *pkt, uint16_t sport, uint16_t dport);
 
 /**
  * @brief Add a new frame to the given packet
+ *
+ * By default, the whole frame content is considered packet payload.
  */
 frame_t *
 packet_add_frame(packet_t *pkt, const struct pcap_pkthdr *header, const u_char *packet);
 
+/**
+ * @brief Move the packet payload offset of frames
+ *
+ * Used while reassembling packets to keep track of which part of the
+ * packet payload is contained in each frame.
+ *
+ * @param packet Packet owner of the frames
+ * @param first Index of the first frame to update
+ * @param offset Bytes to add to frames payload offset
+ */
+void
+packet_shift_frames(packet_t *packet, int first, int32_t offset);
+
 /**
  * @brief Deallocate a packet structure memory
  */
@@ -161,6 +184,47 @@ packet_set_type(packet_t *packet, enum packet_type type);
 void
 packet_set_payload(packet_t *packet, u_char *payload, uint32_t payload_len);
 
+/**
+ * @brief Remove the end of packet payload
+ *
+ * Truncate packet payload to the given length. Frames of UDP and TCP
+ * packets are also truncated after the last stored payload byte, keeping
+ * their original length in the frame header (caplen < len) so saved
+ * captures show the truncation. Frames of TLS and WebSocket packets are
+ * not modified, as their content is not the packet payload.
+ *
+ * @param packet Packet to truncate
+ * @param payload_len New payload length
+ */
+void
+packet_truncate_payload(packet_t *packet, uint32_t payload_len);
+
+/**
+ * @brief Remove a range of bytes from packet payload
+ *
+ * Stored payload bytes after the removed range are kept. As captured
+ * frames can not contain a gap, frames of UDP and TCP packets are
+ * truncated before the first removed byte.
+ *
+ * @param packet Packet to modify
+ * @param offset Payload offset of the first byte to remove
+ * @param len Number of bytes to remove
+ */
+void
+packet_strip_payload(packet_t *packet, uint32_t offset, uint32_t len);
+
+/**
+ * @brief Remove captured frames data after given payload length
+ *
+ * Frames keep their original length in the frame header (caplen < len).
+ * Only UDP and TCP frames are modified.
+ *
+ * @param packet Packet owner of the frames
+ * @param payload_len Payload bytes that frames will store
+ */
+void
+packet_truncate_frames(packet_t *packet, uint32_t payload_len);
+
 /**
  * @brief Getter for capture payload size
  */
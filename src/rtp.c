@@ -30,11 +30,15 @@
  */
 
 #include "config.h"
+#include <ctype.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include "rtp.h"
 #include "sip.h"
 #include "vector.h"
+#include "hep.h"
 
 /**
  * @brief Known RTP encodings
@@ -164,13 +168,7 @@ rtp_check_packet(packet_t *packet)
     rtp_stream_t *reverse;
     u_char format = 0;
     u_char *payload;
-    uint32_t size, bsize;
-    uint16_t len;
-    struct rtcp_hdr_generic hdr;
-    struct rtcp_hdr_sr hdr_sr;
-    struct rtcp_hdr_xr hdr_xr;
-    struct rtcp_blk_xr blk_xr;
-    struct rtcp_blk_xr_voip blk_xr_voip;
+    uint32_t size;
 
     // Get packet data
     payload = packet_payload(packet);
@@ -250,82 +248,222 @@ rtp_check_packet(packet_t *packet)
     } else if (data_is_rtcp(payload, size) == 0) {
         // Find the matching stream
         if ((stream = rtp_find_stream(src, dst))) {
-
             // Parse all packet payload headers
-            while ((int32_t) size > 0) {
+            stream_parse_rtcp(stream, stream, payload, size);
 
-                // Check we have at least rtcp generic info
-                if (size < sizeof(struct rtcp_hdr_generic))
-                    break;
+            // Add packet to stream
+            stream_complete(stream, src);
+            stream_add_packet(stream, packet);
+        }
+    } else {
+      return NULL;
+    }
 
-                memcpy(&hdr, payload, sizeof(hdr));
+    return stream;
+}
 
-                // Check RTP version
-                if (RTP_VERSION(hdr.version) != RTP_VERSION_RFC1889)
-                    break;
+void
+stream_parse_rtcp(rtp_stream_t *sender, rtp_stream_t *receiver, u_char *payload, uint32_t size)
+{
+    uint32_t bsize, boff;
+    uint16_t len;
+    struct rtcp_hdr_generic hdr;
+    struct rtcp_hdr_sr hdr_sr;
+    struct rtcp_hdr_xr hdr_xr;
+    struct rtcp_blk_sr blk_sr;
+    struct rtcp_blk_xr blk_xr;
+    struct rtcp_blk_xr_voip blk_xr_voip;
 
-                // Header length
-                if ((len = ntohs(hdr.len) * 4 + 4) > size)
-                    break;
+    // Parse all packet payload headers
+    while ((int32_t) size > 0) {
 
-                // Check RTCP packet header typ
-                switch (hdr.type) {
-                    case RTCP_HDR_SR:
-                        // Get Sender Report header
-                        memcpy(&hdr_sr, payload, sizeof(hdr_sr));
-                        stream->rtcpinfo.spc = ntohl(hdr_sr.spc);
-                        break;
-                    case RTCP_HDR_RR:
-                    case RTCP_HDR_SDES:
-                    case RTCP_HDR_BYE:
-                    case RTCP_HDR_APP:
-                    case RTCP_RTPFB:
-                    case RTCP_PSFB:
-                        break;
-                    case RTCP_XR:
-                        // Get Sender Report Extended header
-                        memcpy(&hdr_xr, payload, sizeof(hdr_xr));
-                        bsize = sizeof(hdr_xr);
-
-                        // Read all report blocks
-                        while (bsize < ntohs(hdr_xr.len) * 4 + 4) {
-                            // Read block header
-                            memcpy(&blk_xr, payload + bsize, sizeof(blk_xr));
-                            // Check block type
-                            switch (blk_xr.type) {
-                                case RTCP_XR_VOIP_METRCS:
-                                    memcpy(&blk_xr_voip, payload + sizeof(hdr_xr), sizeof(blk_xr_voip));
-                                    stream->rtcpinfo.fdiscard = blk_xr_voip.drate;
-                                    stream->rtcpinfo.flost = blk_xr_voip.lrate;
-                                    stream->rtcpinfo.mosl = blk_xr_voip.moslq;
-                                    stream->rtcpinfo.mosc = blk_xr_voip.moscq;
-                                    break;
-                                default: break;
-                            }
-                            bsize += ntohs(blk_xr.len) * 4 + 4;
-                        }
-                        break;
-                    case RTCP_AVB:
-                    case RTCP_RSI:
-                    case RTCP_TOKEN:
-                    default:
-                        // Not handled headers. Skip the rest of this packet
-                        size = 0;
+        // Check we have at least rtcp generic info
+        if (size < sizeof(struct rtcp_hdr_generic))
+            break;
+
+        memcpy(&hdr, payload, sizeof(hdr));
+
+        // Check RTP version
+        if (RTP_VERSION(hdr.version) != RTP_VERSION_RFC1889)
+            break;
+
+        // Header length
+        if ((len = ntohs(hdr.len) * 4 + 4) > size)
+            break;
+
+        // Check RTCP packet header typ
+        switch (hdr.type) {
+            case RTCP_HDR_SR:
+            case RTCP_HDR_RR:
+                if (hdr.type == RTCP_HDR_SR) {
+                    // Get Sender Report header
+                    if (len < RTCP_SR_HDR_LENGTH)
                         break;
+                    memcpy(&hdr_sr, payload, RTCP_SR_HDR_LENGTH);
+                    sender->rtcpinfo.spc = ntohl(hdr_sr.spc);
+                    boff = RTCP_SR_HDR_LENGTH;
+                } else {
+                    boff = RTCP_RR_HDR_LENGTH;
                 }
-                payload += len;
-                size -= len;
-            }
 
-            // Add packet to stream
-            stream_complete(stream, src);
-            stream_add_packet(stream, packet);
+                // Get first report block
+                if (RTCP_RCOUNT(hdr.version) && boff + sizeof(blk_sr) <= len) {
+                    memcpy(&blk_sr, payload + boff, sizeof(blk_sr));
+                    receiver->rtcpinfo.flost = blk_sr.flost;
+                    receiver->rtcpinfo.plost = (blk_sr.plost.pl1 << 16) | (blk_sr.plost.pl2 << 8) | blk_sr.plost.pl3;
+                    receiver->rtcpinfo.jitter = ntohl(blk_sr.ijitter);
+                }
+                break;
+            case RTCP_HDR_SDES:
+            case RTCP_HDR_BYE:
+            case RTCP_HDR_APP:
+            case RTCP_RTPFB:
+            case RTCP_PSFB:
+                break;
+            case RTCP_XR:
+                // Get Sender Report Extended header
+                if (len < sizeof(hdr_xr))
+                    break;
+                memcpy(&hdr_xr, payload, sizeof(hdr_xr));
+                bsize = sizeof(hdr_xr);
+
+                // Read all report blocks
+                while (bsize + sizeof(blk_xr) <= len) {
+                    // Read block header
+                    memcpy(&blk_xr, payload + bsize, sizeof(blk_xr));
+                    // Check block type
+                    switch (blk_xr.type) {
+                        case RTCP_XR_VOIP_METRCS:
+                            if (bsize + sizeof(blk_xr_voip) > len)
+                                break;
+                            memcpy(&blk_xr_voip, payload + bsize, sizeof(blk_xr_voip));
+                            receiver->rtcpinfo.fdiscard = blk_xr_voip.drate;
+                            receiver->rtcpinfo.flost = blk_xr_voip.lrate;
+                            receiver->rtcpinfo.mosl = blk_xr_voip.moslq;
+                            receiver->rtcpinfo.mosc = blk_xr_voip.moscq;
+                            break;
+                        default: break;
+                    }
+                    bsize += ntohs(blk_xr.len) * 4 + 4;
+                }
+                break;
+            case RTCP_AVB:
+            case RTCP_RSI:
+            case RTCP_TOKEN:
+            default:
+                // Not handled headers. Skip the rest of this packet
+                size = 0;
+                break;
         }
+        payload += len;
+        size -= len;
+    }
+}
+
+void
+stream_parse_report(rtp_stream_t *sender, rtp_stream_t *receiver, const char *report)
+{
+    double value;
+
+    // Sender information (JSON RTCP reports)
+    if (hep_report_value(report, "packets", &value) == 0)
+        sender->rtcpinfo.spc = (uint32_t) value;
+
+    // Report block information (JSON RTCP reports)
+    if (hep_report_value(report, "fraction_lost", &value) == 0)
+        receiver->rtcpinfo.flost = (uint8_t) value;
+    if (hep_report_value(report, "packets_lost", &value) == 0)
+        receiver->rtcpinfo.plost = (uint32_t) value;
+    if (hep_report_value(report, "ia_jitter", &value) == 0)
+        receiver->rtcpinfo.jitter = (uint32_t) value;
+
+    // Quality summary (QoS reports and RTCP-XR VQ reports)
+    if (hep_report_value(report, "jitter", &value) == 0)
+        receiver->rtcpinfo.jitter = (uint32_t) value;
+    if (hep_report_value(report, "mos", &value) == 0
+        || hep_report_value(report, "moslq", &value) == 0)
+        receiver->rtcpinfo.mosl = (uint8_t) (value * 10);
+    if (hep_report_value(report, "moscq", &value) == 0)
+        receiver->rtcpinfo.mosc = (uint8_t) (value * 10);
+}
+
+void
+stream_report_complete(rtp_stream_t *stream, address_t src, packet_t *packet)
+{
+    // Reported streams are displayed even if RTP is not captured
+    if (!stream_is_complete(stream)) {
+        stream_complete(stream, src);
+        stream_set_format(stream, stream->media->fmtcode);
+    }
+    if (stream->rtcpinfo.spc > stream->pktcnt) {
+        stream->pktcnt = stream->rtcpinfo.spc;
+    } else if (!stream->pktcnt) {
+        stream->pktcnt = 1;
+    }
+    if (!stream->time.tv_sec)
+        stream->time = packet_time(packet);
+    stream->lasttm = (int) time(NULL);
+}
+
+rtp_stream_t *
+rtp_check_report(packet_t *packet, const char *callid)
+{
+    sip_call_t *call;
+    rtp_stream_t *stream, *reverse;
+    rtp_stream_t unused = { };
+    address_t src;
+    u_char *payload;
+    uint32_t size;
+
+    // Report must be related with an existing dialog
+    if (!callid || !(call = sip_find_by_callid(callid)))
+        return NULL;
+
+    // Stream sent by the reporter (described by sender information)
+    stream = rtp_find_call_report_stream(call, packet->src, packet->dst);
+    // Stream received by the reporter (described by reception information)
+    reverse = rtp_find_call_report_stream(call, packet->dst, packet->src);
+    if (reverse == stream)
+        reverse = NULL;
+
+    if (!stream && !reverse)
+        return NULL;
+
+    // Get packet data
+    payload = packet_payload(packet);
+    size = packet_payloadlen(packet);
+
+    if (data_is_rtcp(payload, size) == 0) {
+        // Raw RTCP report
+        stream_parse_rtcp(stream ? stream : &unused, reverse ? reverse : &unused, payload, size);
     } else {
-      return NULL;
+        // Text report (packet payload is always NULL terminated)
+        stream_parse_report(stream ? stream : &unused, reverse ? reverse : &unused, (const char *) payload);
     }
 
-    return stream;
+    if (stream) {
+        // Reporter sends RTP from the address it receives RTP (not from RTCP port)
+        src = packet->src;
+        if (reverse) {
+            src = reverse->dst;
+        } else if (packet->dst.port == stream->dst.port + 1 && src.port) {
+            src.port--;
+        }
+        stream_report_complete(stream, src, packet);
+    }
+
+    if (reverse) {
+        // Peer sends RTP from the address it receives RTP
+        src = packet->dst;
+        if (stream) {
+            src = stream->dst;
+        } else if (packet->src.port == reverse->dst.port + 1 && src.port) {
+            src.port--;
+        }
+        stream_report_complete(reverse, src, packet);
+    }
+
+    return (stream) ? stream : reverse;
 }
 
 rtp_stream_t *
@@ -407,21 +545,24 @@ rtp_stream_t *
 rtp_find_call_stream(struct sip_call *call, address_t src, address_t dst)
 {
     rtp_stream_t *stream;
+    sip_call_endpoint_t *endpoint;
     vector_iter_t it;
 
-    // Create an iterator for call streams
-    it = vector_iterator(call->streams);
+    // Get streams with this destination
+    if (!(endpoint = call_find_endpoint(call, dst)))
+        return NULL;
+
+    // Create an iterator for endpoint streams
+    it = vector_iterator(endpoint->streams);
 
     // Look for an incomplete stream with this destination
     vector_iterator_set_last(&it);
     while ((stream = vector_iterator_prev(&it))) {
-        if (addressport_equals(dst, stream->dst)) {
-            if (!src.port) {
+        if (!src.port) {
+            return stream;
+        } else {
+            if (!stream->pktcnt) {
                 return stream;
-            } else {
-                if (!stream->pktcnt) {
-                    return stream;
-                }
             }
         }
     }
@@ -439,15 +580,19 @@ rtp_stream_t *
 rtp_find_call_exact_stream(struct sip_call *call, address_t src, address_t dst)
 {
     rtp_stream_t *stream;
+    sip_call_endpoint_t *endpoint;
     vector_iter_t it;
 
-    // Create an iterator for call streams
-    it = vector_iterator(call->streams);
+    // Get streams with this destination
+    if (!(endpoint = call_find_endpoint(call, dst)))
+        return NULL;
+
+    // Create an iterator for endpoint streams
+    it = vector_iterator(endpoint->streams);
 
     vector_iterator_set_last(&it);
     while ((stream = vector_iterator_prev(&it))) {
-        if (addressport_equals(src, stream->src) &&
-            addressport_equals(dst, stream->dst)) {
+        if (addressport_equals(src, stream->src)) {
             return stream;
         }
     }
@@ -456,6 +601,39 @@ rtp_find_call_exact_stream(struct sip_call *call, address_t src, address_t dst)
     return NULL;
 }
 
+rtp_stream_t *
+rtp_find_call_report_stream(struct sip_call *call, address_t src, address_t dst)
+{
+    rtp_stream_t *stream;
+    rtp_stream_t *candidate = NULL;
+    vector_iter_t it;
+
+    // Create an iterator for call streams
+    it = vector_iterator(call->streams);
+
+    vector_iterator_set_last(&it);
+    while ((stream = vector_iterator_prev(&it))) {
+        // Only RTP streams are displayed
+        if (stream->type != PACKET_RTP)
+            continue;
+
+        // Destination must be RTP or RTCP address of the stream
+        if (!address_equals(dst, stream->dst))
+            continue;
+        if (dst.port != stream->dst.port && dst.port != stream->dst.port + 1)
+            continue;
+
+        // Prefer streams with the same source address
+        if (stream_is_complete(stream) && address_equals(src, stream->src))
+            return stream;
+
+        if (!candidate)
+            candidate = stream;
+    }
+
+    return candidate;
+}
+
 int
 stream_is_older(rtp_stream_t *one, rtp_stream_t *two)
 {
@@ -49,6 +49,11 @@
 
 // RTCP common header length
 #define RTCP_HDR_LENGTH 4
+// RTCP Sender and Receiver Report header length (without report blocks)
+#define RTCP_SR_HDR_LENGTH 28
+#define RTCP_RR_HDR_LENGTH 8
+// RTCP report count is the last 5 bits
+#define RTCP_RCOUNT(octet) ((octet) & 0x1F)
 
 // If stream does not receive a packet in this seconds, we consider it inactive
 #define STREAM_INACTIVE_SECS 3
@@ -114,25 +119,28 @@ struct rtp_stream {
     //! Unix timestamp of last received packet
     int lasttm;
 
-    // Stream information (depending on type)
-    union {
-        struct {
-            //! Format of first received packet of stre
-            uint32_t fmtcode;
-        } rtpinfo;
-        struct {
-            //! Sender packet count
-            uint32_t spc;
-            //! Fraction lost x/256
-            uint8_t flost;
-            //! uint8_t discarded x/256
-            uint8_t fdiscard;
-            //! MOS - listening Quality
-            uint8_t mosl;
-            //! MOS - Conversational Quality
-            uint8_t mosc;
-        } rtcpinfo;
-    };
+    // Stream information
+    struct {
+        //! Format of first received packet of stre
+        uint32_t fmtcode;
+    } rtpinfo;
+    // Stream quality information (from RTCP or QoS reports)
+    struct {
+        //! Sender packet count
+        uint32_t spc;
+        //! Cumulative number of packets lost
+        uint32_t plost;
+        //! Interarrival jitter
+        uint32_t jitter;
+        //! Fraction lost x/256
+        uint8_t flost;
+        //! uint8_t discarded x/256
+        uint8_t fdiscard;
+        //! MOS - listening Quality
+        uint8_t mosl;
+        //! MOS - Conversational Quality
+        uint8_t mosc;
+    } rtcpinfo;
 };
 
 struct rtcp_hdr_generic
@@ -300,6 +308,61 @@ rtp_get_standard_format(uint32_t code);
 rtp_stream_t *
 rtp_check_packet(packet_t *packet);
 
+/**
+ * @brief Parse RTCP packet payload into stream quality information
+ *
+ * Sender information describes the stream sent by the reporter, while
+ * report blocks and extended reports describe the stream it receives.
+ *
+ * @param sender Stream to fill with sender information
+ * @param receiver Stream to fill with reception information
+ * @param payload RTCP packet payload (may contain compound packets)
+ * @param size payload length
+ */
+void
+stream_parse_rtcp(rtp_stream_t *sender, rtp_stream_t *receiver, u_char *payload, uint32_t size);
+
+/**
+ * @brief Parse a text quality report into stream quality information
+ *
+ * Quality reports can be either JSON (RTCP reports sent by media servers
+ * through HEP) or key=value lists (RTCP-XR VQ reports). Only known keys
+ * are used, the rest of the report is ignored.
+ *
+ * @param sender Stream to fill with sender information
+ * @param receiver Stream to fill with reception information
+ * @param report NULL terminated report text
+ */
+void
+stream_parse_report(rtp_stream_t *sender, rtp_stream_t *receiver, const char *report);
+
+/**
+ * @brief Mark a stream described by a quality report as seen
+ *
+ * Reported streams are displayed even if their RTP is not captured.
+ *
+ * @param stream Reported stream
+ * @param src RTP source address of the stream
+ * @param packet Packet containing the report
+ */
+void
+stream_report_complete(rtp_stream_t *stream, address_t src, packet_t *packet);
+
+/**
+ * @brief Check a media quality report for a given dialog
+ *
+ * Quality reports are received with a correlation identifier (the Call-ID
+ * of the dialog) so there is no need to look for the stream in every call.
+ * Packet source and destination are used to find the reported streams
+ * in the dialog: the stream sent by the reporter and the one it receives.
+ *
+ * @param packet Packet containing the report (RTCP or text report)
+ * @param callid Call-ID of the dialog the report belongs to
+ * @return reported stream or NULL if no stream matches the report
+ */
+rtp_stream_t *
+rtp_check_report(packet_t *packet, const char *callid);
+
 rtp_stream_t *
 rtp_find_stream_format(address_t src, address_t dst, uint32_t format);
 
@@ -312,6 +375,20 @@ rtp_find_call_stream(struct sip_call *call, address_t src, address_t dst);
 rtp_stream_t *
 rtp_find_call_exact_stream(struct sip_call *call, address_t src, address_t dst);
 
+/**
+ * @brief Find the RTP stream of a call described by a quality report
+ *
+ * Reports can be sent between RTP or RTCP addresses, so destination
+ * port is also matched against RTCP port (RTP port + 1).
+ *
+ * @param call SIP call structure
+ * @param src Source address of the report
+ * @param dst Destination address of the report
+ * @return RTP stream or NULL if not found
+ */
+rtp_stream_t *
+rtp_find_call_report_stream(struct sip_call *call, address_t src, address_t dst);
+
 /**
  * @brief Check if a message is older than other
  *
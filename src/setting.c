@@ -56,6 +56,10 @@ setting_t settings[SETTING_COUNT] = {
     { SETTING_SIP_NOINCOMPLETE,   "sip.noincomplete",   SETTING_FMT_ENUM,    SETTING_ON,  SETTING_ENUM_ONOFF },
     { SETTING_SIP_HEADER_X_CID,   "sip.xcid",           SETTING_FMT_STRING,  "X-Call-ID|X-CID", NULL },
     { SETTING_SIP_CALLS,          "sip.calls",          SETTING_FMT_ENUM,    SETTING_OFF, SETTING_ENUM_ONOFF },
+    { SETTING_SIP_RETENTION,      "sip.retention",      SETTING_FMT_ENUM,    SETTING_OFF, SETTING_ENUM_RETENTION },
+    { SETTING_SIP_RETENTION_MAXBODY, "sip.retention.maxbody", SETTING_FMT_NUMBER, "1024",   NULL },
+    { SETTING_SIP_RETENTION_KEEP, "sip.retention.keep", SETTING_FMT_STRING,  "application/sdp", NULL },
+    { SETTING_SIP_RETENTION_METHODS, "sip.retention.methods", SETTING_FMT_STRING, "",       NULL },
     { SETTING_SAVEPATH,           "savepath",           SETTING_FMT_STRING,  "",          NULL },
     { SETTING_DISPLAY_ALIAS,      "displayalias",       SETTING_FMT_ENUM,    SETTING_OFF, SETTING_ENUM_ONOFF },
     { SETTING_CL_SCROLLSTEP,      "cl.scrollstep",      SETTING_FMT_NUMBER,  "4",         NULL },
@@ -94,14 +98,101 @@ setting_t settings[SETTING_COUNT] = {
 #endif
 };
 
-setting_t *
-setting_by_id(int id)
+//! Typed enum values of settings value lists
+setting_enum_value_t setting_enum_values[] = {
+    { SETTING_ENUM_SDP_INFO,  SETTING_SDP_OFF,               "off" },
+    { SETTING_ENUM_SDP_INFO,  SETTING_SDP_FIRST,             "first" },
+    { SETTING_ENUM_SDP_INFO,  SETTING_SDP_FULL,              "full" },
+    { SETTING_ENUM_SDP_INFO,  SETTING_SDP_COMPRESSED,        "compressed" },
+    { SETTING_ENUM_SDP_INFO,  SETTING_SDP_COMPRESSED + 1,    NULL },
+    { SETTING_ENUM_MEDIA,     SETTING_MEDIA_OFF,             SETTING_OFF },
+    { SETTING_ENUM_MEDIA,     SETTING_MEDIA_ON,              SETTING_ON },
+    { SETTING_ENUM_MEDIA,     SETTING_MEDIA_ACTIVE,          SETTING_ACTIVE },
+    { SETTING_ENUM_MEDIA,     SETTING_MEDIA_ACTIVE + 1,      NULL },
+    { SETTING_ENUM_COLORMODE, SETTING_COLORMODE_REQUEST,     "request" },
+    { SETTING_ENUM_COLORMODE, SETTING_COLORMODE_CSEQ,        "cseq" },
+    { SETTING_ENUM_COLORMODE, SETTING_COLORMODE_CALLID,      "callid" },
+    { SETTING_ENUM_COLORMODE, SETTING_COLORMODE_CALLID + 1,  NULL },
+    { SETTING_ENUM_HIGHLIGHT, SETTING_HIGHLIGHT_BOLD,        "bold" },
+    { SETTING_ENUM_HIGHLIGHT, SETTING_HIGHLIGHT_REVERSE,     "reverse" },
+    { SETTING_ENUM_HIGHLIGHT, SETTING_HIGHLIGHT_REVERSEBOLD, "reversebold" },
+    { SETTING_ENUM_HIGHLIGHT, SETTING_HIGHLIGHT_REVERSEBOLD + 1, NULL },
+    { SETTING_ENUM_RETENTION, SETTING_RETENTION_OFF,         SETTING_OFF },
+    { SETTING_ENUM_RETENTION, SETTING_RETENTION_TRUNCATE,    "truncate" },
+    { SETTING_ENUM_RETENTION, SETTING_RETENTION_DROP,        "drop" },
+    { SETTING_ENUM_RETENTION, SETTING_RETENTION_DROP + 1,    NULL },
+    { SETTING_ENUM_STORAGE,   SETTING_STORAGE_NONE,          "none" },
+    { SETTING_ENUM_STORAGE,   SETTING_STORAGE_MEMORY,        "memory" },
+    { SETTING_ENUM_STORAGE,   SETTING_STORAGE_MEMORY + 1,    NULL },
+    { NULL, 0, NULL },
+};
+
+//! Registered setting change callbacks
+setting_callback_t setting_callbacks[MAX_SETTING_CALLBACKS];
+int setting_callbackcnt = 0;
+
+//! Last setting generation
+unsigned int setting_lastgen = 0;
+
+void
+setting_update_cache(setting_t *sett)
 {
     int i;
+
+    sett->ivalue = (strlen(sett->value)) ? atoi(sett->value) : -1;
+
+    sett->evalue = -1;
+    if (sett->fmt == SETTING_FMT_ENUM && sett->valuelist) {
+        for (i = 0; sett->valuelist[i]; i++) {
+            if (!strcmp(sett->valuelist[i], sett->value)) {
+                sett->evalue = i;
+                break;
+            }
+        }
+    }
+
+    if (!strcmp(sett->value, SETTING_ON) || !strcmp(sett->value, SETTING_YES)) {
+        sett->bvalue = 1;
+    } else if (!strcmp(sett->value, SETTING_OFF) || !strcmp(sett->value, SETTING_NO)) {
+        sett->bvalue = 0;
+    } else {
+        sett->bvalue = -1;
+    }
+}
+
+void
+settings_init()
+{
+    setting_enum_value_t *enumv;
+    int i;
     for (i = 0; i < SETTING_COUNT; i++) {
-        if (id == settings[i].id)
-            return &settings[i];
+        // setting_by_id requires settings array sorted by setting id
+        if (settings[i].id != i) {
+            fprintf(stderr, "Setting %s is not sorted by id (%d at position %d)\n",
+                    settings[i].name ? settings[i].name : "<missing>", settings[i].id, i);
+            abort();
+        }
+        setting_update_cache(&settings[i]);
+    }
+
+    for (enumv = setting_enum_values; enumv->valuelist; enumv++) {
+        // setting_get_enum values are the position of value strings
+        for (i = 0; i < enumv->value && enumv->valuelist[i]; i++);
+        if (i != enumv->value || (enumv->valuelist[i] == NULL) != (enumv->str == NULL)
+            || (enumv->str && strcmp(enumv->valuelist[i], enumv->str))) {
+            fprintf(stderr, "Setting enum value %d does not match string %s\n",
+                    enumv->value, enumv->str ? enumv->str : "<end of list>");
+            abort();
+        }
     }
+}
+
+setting_t *
+setting_by_id(int id)
+{
+    // Settings array is sorted by setting id
+    if (id >= 0 && id < SETTING_COUNT)
+        return &settings[id];
     return NULL;
 }
 
@@ -155,24 +246,48 @@ int
 setting_get_intvalue(int id)
 {
     const setting_t *sett = setting_by_id(id);
-    return (sett && strlen(sett->value)) ? atoi(sett->value) : -1;
+    return (sett) ? sett->ivalue : -1;
+}
+
+int
+setting_get_enum(int id)
+{
+    const setting_t *sett = setting_by_id(id);
+    return (sett) ? sett->evalue : -1;
 }
 
 void
 setting_set_value(int id, const char *value)
 {
+    int i;
     setting_t *sett = setting_by_id(id);
-    if (sett) {
-        memset(sett->value, 0, sizeof(sett->value));
-        if (value) {
-            if (strlen(value) < MAX_SETTING_LEN) {
-                strcpy(sett->value, value);
-            } else {
-                fprintf(stderr, "Setting value %s for %s is too long\n", sett->value, sett->name);
-                exit(1);
-            }
+
+    if (!sett)
+        return;
+
+    // Nothing to do if value has not changed
+    if (!strcmp(sett->value, (value) ? value : ""))
+        return;
+
+    memset(sett->value, 0, sizeof(sett->value));
+    if (value) {
+        if (strlen(value) < MAX_SETTING_LEN) {
+            strcpy(sett->value, value);
+        } else {
+            fprintf(stderr, "Setting value %s for %s is too long\n", value, sett->name);
+            exit(1);
         }
     }
+
+    // Update cached values
+    setting_update_cache(sett);
+    sett->generation = ++setting_lastgen;
+
+    // Notify subsystems about the change
+    for (i = 0; i < setting_callbackcnt; i++) {
+        if (setting_callbacks[i].id == id)
+            setting_callbacks[i].callback(id, setting_callbacks[i].data);
+    }
 }
 
 void
@@ -186,15 +301,15 @@ setting_set_intvalue(int id, int value)
 int
 setting_enabled(int id)
 {
-    return setting_has_value(id, "on") ||
-           setting_has_value(id, "yes");
+    const setting_t *sett = setting_by_id(id);
+    return (sett) ? sett->bvalue == 1 : 0;
 }
 
 int
 setting_disabled(int id)
 {
-    return setting_has_value(id, "off") ||
-           setting_has_value(id, "no");
+    const setting_t *sett = setting_by_id(id);
+    return (sett) ? sett->bvalue == 0 : 0;
 }
 
 int
@@ -256,6 +371,33 @@ setting_enum_next(int id, const char *value)
     return NULL;
 }
 
+unsigned int
+setting_generation(int id)
+{
+    const setting_t *sett;
+
+    if (id == -1)
+        return setting_lastgen;
+
+    return ((sett = setting_by_id(id))) ? sett->generation : 0;
+}
+
+int
+setting_add_callback(int id, setting_change_cb callback, void *data)
+{
+    if (!setting_by_id(id) || !callback)
+        return -1;
+
+    if (setting_callbackcnt == MAX_SETTING_CALLBACKS)
+        return -1;
+
+    setting_callbacks[setting_callbackcnt].id = id;
+    setting_callbacks[setting_callbackcnt].callback = callback;
+    setting_callbacks[setting_callbackcnt].data = data;
+    setting_callbackcnt++;
+    return 0;
+}
+
 void
 settings_dump()
 {
@@ -61,6 +61,7 @@ typedef struct setting_option setting_t;
 #define SETTING_ENUM_STORAGE     (const char *[]){ "none", "memory", NULL }
 #define SETTING_ENUM_HEPVERSION  (const char *[]){ "2", "3", NULL }
 #define SETTING_ENUM_MEDIA       (const char *[]){ "off", "on", "active", NULL }
+#define SETTING_ENUM_RETENTION   (const char *[]){ "off", "truncate", "drop", NULL }
 
 //! Other useful defines
 #define SETTING_ON  "on"
@@ -69,6 +70,51 @@ typedef struct setting_option setting_t;
 #define SETTING_NO  "no"
 #define SETTING_ACTIVE "active"
 
+//! Max number of registered setting change callbacks
+#define MAX_SETTING_CALLBACKS 32
+
+//! Typed values of SETTING_ENUM_SDP_INFO (same order as the enum strings)
+enum setting_sdp_info {
+    SETTING_SDP_OFF = 0,
+    SETTING_SDP_FIRST,
+    SETTING_SDP_FULL,
+    SETTING_SDP_COMPRESSED,
+};
+
+//! Typed values of SETTING_ENUM_MEDIA (same order as the enum strings)
+enum setting_media {
+    SETTING_MEDIA_OFF = 0,
+    SETTING_MEDIA_ON,
+    SETTING_MEDIA_ACTIVE,
+};
+
+//! Typed values of SETTING_ENUM_COLORMODE (same order as the enum strings)
+enum setting_colormode {
+    SETTING_COLORMODE_REQUEST = 0,
+    SETTING_COLORMODE_CSEQ,
+    SETTING_COLORMODE_CALLID,
+};
+
+//! Typed values of SETTING_ENUM_HIGHLIGHT (same order as the enum strings)
+enum setting_highlight {
+    SETTING_HIGHLIGHT_BOLD = 0,
+    SETTING_HIGHLIGHT_REVERSE,
+    SETTING_HIGHLIGHT_REVERSEBOLD,
+};
+
+//! Typed values of SETTING_ENUM_RETENTION (same order as the enum strings)
+enum setting_retention {
+    SETTING_RETENTION_OFF = 0,
+    SETTING_RETENTION_TRUNCATE,
+    SETTING_RETENTION_DROP,
+};
+
+//! Typed values of SETTING_ENUM_STORAGE (same order as the enum strings)
+enum setting_storage {
+    SETTING_STORAGE_NONE = 0,
+    SETTING_STORAGE_MEMORY,
+};
+
 
 //! Available setting Options
 enum setting_id {
@@ -92,6 +138,10 @@ enum setting_id {
     SETTING_SIP_NOINCOMPLETE,
     SETTING_SIP_HEADER_X_CID,
     SETTING_SIP_CALLS,
+    SETTING_SIP_RETENTION,
+    SETTING_SIP_RETENTION_MAXBODY,
+    SETTING_SIP_RETENTION_KEEP,
+    SETTING_SIP_RETENTION_METHODS,
     SETTING_SAVEPATH,
     SETTING_DISPLAY_ALIAS,
     SETTING_CL_SCROLLSTEP,
@@ -126,6 +176,7 @@ enum setting_id {
     SETTING_EEP_LISTEN_ADDR,
     SETTING_EEP_LISTEN_PORT,
     SETTING_EEP_LISTEN_PASS,
+    //! Not used anymore (unknown HEP chunks are skipped), kept for configuration compatibility
     SETTING_EEP_LISTEN_UUID,
 #endif
     SETTING_COUNT
@@ -152,8 +203,75 @@ struct setting_option {
     char value[MAX_SETTING_LEN];
     //! Compa separated valid values
     const char **valuelist;
+    //! Cached numeric value (-1 if value is empty)
+    int ivalue;
+    //! Cached enum value index (-1 if not a valid enum value)
+    int evalue;
+    //! Cached boolean value (1 for on/yes, 0 for off/no, -1 otherwise)
+    int bvalue;
+    //! Generation of the last change of this setting value
+    unsigned int generation;
+};
+
+/**
+ * @brief Setting change callback
+ *
+ * Callbacks are invoked after the setting value has been changed
+ * so subsystems can rebuild any state derived from it.
+ */
+typedef void (*setting_change_cb)(int id, void *data);
+
+//! Shorter declaration of setting_callback struct
+typedef struct setting_callback setting_callback_t;
+//! Shorter declaration of setting_enum_value struct
+typedef struct setting_enum_value setting_enum_value_t;
+
+/**
+ * @brief Setting change callback registration
+ */
+struct setting_callback {
+    //! Setting id
+    int id;
+    //! Function to invoke on setting change
+    setting_change_cb callback;
+    //! User data for the callback
+    void *data;
+};
+
+/**
+ * @brief Typed enum value and its string in a setting value list
+ *
+ * Used to check typed enums match the position of their strings.
+ * A NULL string checks the value is the end of the list.
+ */
+struct setting_enum_value {
+    //! Setting value list
+    const char **valuelist;
+    //! Typed enum value (index in the list)
+    int value;
+    //! Expected string at value index
+    const char *str;
 };
 
+/**
+ * @brief Initialize settings typed values
+ *
+ * Parse default values of all settings into their cached typed values.
+ * This must be invoked before any setting is read or changed.
+ * Aborts if settings array is not sorted by setting id or if typed
+ * enum values don't match their strings position.
+ */
+void
+settings_init();
+
+/**
+ * @brief Parse setting value into its cached typed values
+ *
+ * @param sett Setting structure to update
+ */
+void
+setting_update_cache(setting_t *sett);
+
 setting_t *
 setting_by_id(int id);
 
@@ -190,6 +308,18 @@ setting_get_value(int id);
 int
 setting_get_intvalue(int id);
 
+/**
+ * @brief Return the index of current value in the setting valid values
+ *
+ * This value is cached when the setting changes, so it's cheap enough
+ * to be used in hot paths instead of comparing setting strings.
+ *
+ * @param id Setting id from settings enum
+ * @return enum value index or -1 if setting is not a valid enum value
+ */
+int
+setting_get_enum(int id);
+
 void
 setting_set_value(int id, const char *value);
 
@@ -211,6 +341,32 @@ setting_toggle(int id);
 const char *
 setting_enum_next(int id, const char *value);
 
+/**
+ * @brief Return the generation of given setting
+ *
+ * Generation is increased each time the setting value changes. Passing
+ * -1 as setting id returns the generation of the last changed setting.
+ *
+ * @param id Setting id from settings enum or -1
+ * @return setting generation counter
+ */
+unsigned int
+setting_generation(int id);
+
+/**
+ * @brief Register a callback for setting value changes
+ *
+ * Callback will be invoked only when the new value differs from the
+ * previous one.
+ *
+ * @param id Setting id from settings enum
+ * @param callback Function to invoke after the setting changes
+ * @param data User data passed to the callback
+ * @return 0 on success, -1 if callback can not be registered
+ */
+int
+setting_add_callback(int id, setting_change_cb callback, void *data);
+
 /**
  * @brief Dump configuration settings
  *
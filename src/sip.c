@@ -36,6 +36,7 @@
 #include "option.h"
 #include "setting.h"
 #include "filter.h"
+#include "capture.h"
 
 /**
  * @brief Linked list of parsed calls
@@ -198,9 +199,19 @@ sip_init(int limit, int only_calls, int no_incomplete)
     regcomp(&calls.reg_valid, "^([A-Z]+ [a-zA-Z]+:|SIP/2.0 [0-9]{3})", match_flags & ~REG_NEWLINE);
     regcomp(&calls.reg_cl, "^(Content-Length|l):[ ]*([0-9]+)[ ]*\r$", match_flags);
     regcomp(&calls.reg_body, "\r\n\r\n(.*)", match_flags & ~REG_NEWLINE);
+    regcomp(&calls.reg_ctype, "^(Content-Type|c):[ ]*([^ ;\r]+)", match_flags);
     regcomp(&calls.reg_reason, "Reason:[ ]*[^\r]*;text=\"([^\r]+)\"", match_flags);
     regcomp(&calls.reg_warning, "Warning:[ ]*([0-9]*)", match_flags);
 
+    // Initialize payload retention policy
+    if (sip_retention_load(&calls.retention) != 0) {
+        fprintf(stderr, "%s setting contains unknown methods, they will be ignored.\n",
+            setting_name(SETTING_SIP_RETENTION_METHODS));
+    }
+    setting_add_callback(SETTING_SIP_RETENTION, sip_retention_changed, NULL);
+    setting_add_callback(SETTING_SIP_RETENTION_MAXBODY, sip_retention_changed, NULL);
+    setting_add_callback(SETTING_SIP_RETENTION_KEEP, sip_retention_changed, NULL);
+    setting_add_callback(SETTING_SIP_RETENTION_METHODS, sip_retention_changed, NULL);
 }
 
 void
@@ -224,6 +235,7 @@ sip_deinit()
     regfree(&calls.reg_valid);
     regfree(&calls.reg_cl);
     regfree(&calls.reg_body);
+    regfree(&calls.reg_ctype);
     regfree(&calls.reg_reason);
     regfree(&calls.reg_warning);
 }
@@ -663,6 +675,10 @@ sip_parse_msg_media(sip_msg_t *msg, const u_char *payload)
                 ADD_STREAM(rtp_stream);
                 ADD_STREAM(rtcp_stream);
 
+                // Index media from previous 'm=' line in the call
+                if (media)
+                    call_add_media(call, media);
+
                 // Create a new media structure for this message
                 if ((media = media_create(msg))) {
                     media_set_type(media, media_type);
@@ -721,6 +737,10 @@ sip_parse_msg_media(sip_msg_t *msg, const u_char *payload)
     ADD_STREAM(rtp_stream);
     ADD_STREAM(rtcp_stream);
 
+    // Index media from last 'm=' line in the call
+    if (media)
+        call_add_media(call, media);
+
     sng_free(tofree);
 
 #undef ADD_STREAM
@@ -745,6 +765,268 @@ sip_parse_extra_headers(sip_msg_t *msg, const u_char *payload)
      }
 }
 
+int
+sip_retention_load(sip_retention_t *retention)
+{
+    char methods[MAX_SETTING_LEN];
+    char *method, *list;
+    int i, unknown = 0;
+
+    memset(retention, 0, sizeof(sip_retention_t));
+    retention->mode = setting_get_enum(SETTING_SIP_RETENTION);
+    retention->maxbody = setting_get_intvalue(SETTING_SIP_RETENTION_MAXBODY);
+    if (retention->maxbody < 0)
+        retention->maxbody = 0;
+
+    // Store kept content types
+    if (setting_get_value(SETTING_SIP_RETENTION_KEEP))
+        strncpy(retention->keep, setting_get_value(SETTING_SIP_RETENTION_KEEP),
+                sizeof(retention->keep) - 1);
+
+    // Build request methods bitmask
+    if (setting_get_value(SETTING_SIP_RETENTION_METHODS)) {
+        strcpy(methods, setting_get_value(SETTING_SIP_RETENTION_METHODS));
+        list = methods;
+        while ((method = strsep(&list, ",")) != NULL) {
+            method = strtrim(method + strspn(method, " \t"));
+            if (!strlen(method))
+                continue;
+
+            // Even if no method is valid, policy is limited to configured ones
+            retention->methods_set = 1;
+
+            // Look for a request method with this name
+            for (i = 0; sip_codes[i].id > 0 && sip_codes[i].id < 32; i++) {
+                if (!strcasecmp(method, sip_codes[i].text))
+                    break;
+            }
+
+            if (sip_codes[i].id > 0 && sip_codes[i].id < 32) {
+                retention->methods |= (1 << sip_codes[i].id);
+            } else {
+                unknown++;
+            }
+        }
+    }
+
+    return unknown;
+}
+
+void
+sip_retention_changed(int id, void *data)
+{
+    sip_retention_t retention;
+
+    // Build the new policy before replacing the current one
+    sip_retention_load(&retention);
+
+    // Avoid replacing the policy while a packet is being parsed
+    capture_lock();
+    calls.retention = retention;
+    capture_unlock();
+}
+
+int
+sip_retention_keeps(const char *ctype, int len)
+{
+    const char *keep = calls.retention.keep;
+    size_t toklen;
+
+    while (*keep) {
+        // Skip separators
+        keep += strspn(keep, ", ");
+        toklen = strcspn(keep, ", ");
+        if (toklen && toklen == (size_t) len && !strncasecmp(keep, ctype, len))
+            return 1;
+        keep += toklen;
+    }
+    return 0;
+}
+
+int
+sip_retention_boundary(const char *ctype, const char *end, char *boundary, size_t size)
+{
+    const char *value;
+    size_t len;
+
+    // Look for boundary parameter in the rest of the header line
+    for (; ctype + 9 < end; ctype++) {
+        if (strncasecmp(ctype, "boundary=", 9))
+            continue;
+
+        // Get parameter value (quoted or token)
+        value = ctype + 9;
+        if (*value == '"') {
+            for (len = 0, value++; value + len < end && value[len] != '"'; len++);
+        } else {
+            for (len = 0; value + len < end && !strchr("; \t\r", value[len]); len++);
+        }
+
+        // Store the delimiter string (boundary prefixed with --)
+        if (!len || len + 3 > size)
+            return 0;
+        sprintf(boundary, "--%.*s", (int) len, value);
+        return 1;
+    }
+    return 0;
+}
+
+int
+sip_retention_keeps_part(const char *part, const char *end)
+{
+    const char *line, *eol, *ctype;
+    int len;
+
+    for (line = part; line < end; line = eol + 2) {
+        if (!(eol = memmem(line, end - line, "\r\n", 2)))
+            eol = end;
+
+        // Empty line ends part headers
+        if (eol == line)
+            break;
+
+        // Check part content type
+        if (eol - line > 13 && !strncasecmp(line, "Content-Type:", 13)) {
+            for (ctype = line + 13; ctype < eol && *ctype == ' '; ctype++);
+            for (len = 0; ctype + len < eol && ctype[len] != ';' && ctype[len] != ' '; len++);
+            return sip_retention_keeps(ctype, len);
+        }
+    }
+
+    // Parts without Content-Type are text/plain
+    return 0;
+}
+
+uint32_t
+sip_retention_multipart(packet_t *packet, uint32_t offset, uint32_t minlen, const char *boundary)
+{
+    const char *payload, *body, *end, *delim, *part = NULL, *partend, *content;
+    uint32_t keeplen = minlen, start, stop, delimoff;
+    size_t blen = strlen(boundary);
+
+    payload = (const char *) packet_payload(packet);
+    body = payload + offset;
+    end = payload + packet_payloadlen(packet);
+
+    // Body parts may contain binary data, so all searches are length bounded
+    for (delim = body; (delim = memmem(delim, end - delim, boundary, blen)); delim += blen) {
+        // Delimiters must be at the beginning of a line
+        if (delim != body && (delim - body < 2 || memcmp(delim - 2, "\r\n", 2)))
+            continue;
+
+        if (part) {
+            // Line break before the delimiter belongs to it
+            partend = (delim == body) ? delim : delim - 2;
+
+            if (sip_retention_keeps_part(part, partend)) {
+                // Store body until the end of this part
+                if ((uint32_t) (partend - payload) > keeplen)
+                    keeplen = partend - payload;
+            } else {
+                // Find the start of this part content
+                if (partend - part >= 2 && !memcmp(part, "\r\n", 2)) {
+                    content = part + 2;
+                } else if ((content = memmem(part, partend - part, "\r\n\r\n", 4))) {
+                    content += 4;
+                } else {
+                    content = partend;
+                }
+
+                // Remove part content (never the body bytes stored by truncate mode)
+                start = content - payload;
+                stop = partend - payload;
+                if (start < minlen)
+                    start = minlen;
+                if (start < stop) {
+                    delimoff = delim - payload - (stop - start);
+                    packet_strip_payload(packet, start, stop - start);
+                    payload = (const char *) packet_payload(packet);
+                    body = payload + offset;
+                    end = payload + packet_payloadlen(packet);
+                    delim = payload + delimoff;
+                }
+            }
+        }
+
+        // Closing delimiter
+        if (end - delim >= (long) blen + 2 && !memcmp(delim + blen, "--", 2))
+            break;
+
+        // Next part starts after delimiter line
+        if (!(part = memmem(delim, end - delim, "\r\n", 2)))
+            break;
+        part += 2;
+    }
+
+    return keeplen;
+}
+
+void
+sip_apply_retention(packet_t *packet)
+{
+    regmatch_t pmatch[3];
+    const char *payload, *body, *ctype, *eol;
+    char method[40], boundary[80];
+    uint32_t len, bodyoff, keeplen;
+    int ctypelen, reqresp;
+
+    // Retention policy disabled
+    if (calls.retention.mode <= SETTING_RETENTION_OFF)
+        return;
+
+    // Only SIP packets payload is limited
+    if (packet->type == PACKET_RTP || packet->type == PACKET_RTCP || !packet->payload)
+        return;
+
+    payload = (const char *) packet_payload(packet);
+    len = packet_payloadlen(packet);
+
+    // Check policy applies to this message method
+    if (calls.retention.methods_set) {
+        // Responses have no request method
+        if (regexec(&calls.reg_method, payload, 2, pmatch, 0) != 0)
+            return;
+        snprintf(method, sizeof(method), "%.*s",
+                 (int)(pmatch[1].rm_eo - pmatch[1].rm_so), payload + pmatch[1].rm_so);
+        reqresp = sip_method_from_str(method);
+        if (reqresp <= 0 || reqresp >= 32 || !(calls.retention.methods & (1 << reqresp)))
+            return;
+    }
+
+    // Headers are always stored
+    if (!(body = memmem(payload, len, "\r\n\r\n", 4)))
+        return;
+    bodyoff = body + 4 - payload;
+
+    // Body small enough to be stored
+    if (len - bodyoff <= (uint32_t) calls.retention.maxbody)
+        return;
+
+    // Truncate mode stores also the first bytes of the body
+    keeplen = bodyoff;
+    if (calls.retention.mode == SETTING_RETENTION_TRUNCATE)
+        keeplen += calls.retention.maxbody;
+
+    // Get message Content-Type header (ignore body part headers)
+    if (regexec(&calls.reg_ctype, payload, 3, pmatch, 0) == 0 && (uint32_t) pmatch[2].rm_so < bodyoff) {
+        ctype = payload + pmatch[2].rm_so;
+        ctypelen = pmatch[2].rm_eo - pmatch[2].rm_so;
+
+        // Content type that must be stored
+        if (sip_retention_keeps(ctype, ctypelen))
+            return;
+
+        // Keep multipart body parts with kept content types
+        if (!strncasecmp(ctype, "multipart/", 10)) {
+            eol = memmem(ctype, payload + bodyoff - ctype, "\r\n", 2);
+            if (sip_retention_boundary(ctype + ctypelen, eol, boundary, sizeof(boundary)))
+                keeplen = sip_retention_multipart(packet, bodyoff, keeplen, boundary);
+        }
+    }
+
+    packet_truncate_payload(packet, keeplen);
+}
+
 void
 sip_calls_clear()
 {
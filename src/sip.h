@@ -41,6 +41,7 @@
 #include "sip_call.h"
 #include "vector.h"
 #include "hash.h"
+#include "setting.h"
 
 #define MAX_SIP_PAYLOAD 10240
 
@@ -52,6 +53,8 @@ typedef struct sip_code sip_code_t;
 typedef struct sip_stats sip_stats_t;
 //! Shorter declaration of sip sort
 typedef struct sip_sort sip_sort_t;
+//! Shorter declaration of sip retention
+typedef struct sip_retention sip_retention_t;
 
 //! SIP Methods
 enum sip_methods {
@@ -110,6 +113,26 @@ struct sip_sort
     bool asc;
 };
 
+/**
+ * @brief Payload retention policy
+ *
+ * Policy parsed from sip.retention settings, it is rebuilt only when
+ * any of those settings change.
+ */
+struct sip_retention
+{
+    //! Retention mode (setting_retention values)
+    int mode;
+    //! Max stored body bytes for not kept content types
+    int maxbody;
+    //! Policy only applies to configured request methods
+    int methods_set;
+    //! Bitmask of request methods the policy applies to
+    int methods;
+    //! Comma separated list of always stored content types
+    char keep[MAX_SETTING_LEN];
+};
+
 /**
  * @brief call structures head list
  *
@@ -146,6 +169,8 @@ struct sip_call_list {
 #endif
     //! Invert match expression result
     int match_invert;
+    //! Payload retention policy
+    sip_retention_t retention;
 
     //! Regexp for payload matching
     regex_t reg_method;
@@ -158,6 +183,7 @@ struct sip_call_list {
     regex_t reg_valid;
     regex_t reg_cl;
     regex_t reg_body;
+    regex_t reg_ctype;
     regex_t reg_reason;
     regex_t reg_warning;
 };
@@ -330,6 +356,96 @@ sip_find_by_callid(const char *callid);
 void
 sip_parse_extra_headers(sip_msg_t *msg, const u_char *payload);
 
+/**
+ * @brief Build payload retention policy from its settings
+ *
+ * Method names are matched case insensitively. Unknown names are
+ * ignored, but policy will still be limited to the configured methods.
+ *
+ * @param retention Policy structure to be filled
+ * @return number of unknown method names
+ */
+int
+sip_retention_load(sip_retention_t *retention);
+
+/**
+ * @brief Rebuild payload retention policy from its settings
+ *
+ * This function is registered as setting change callback for
+ * all sip.retention settings. Settings can be changed from the
+ * interface, so the new policy is replaced with capture locked.
+ *
+ * @param id Setting id of changed setting
+ * @param data Unused callback data
+ */
+void
+sip_retention_changed(int id, void *data);
+
+/**
+ * @brief Check if a content type is in the retention keep list
+ *
+ * @param ctype Content type (not NULL terminated)
+ * @param len Content type length
+ * @return 1 if content type must be stored, 0 otherwise
+ */
+int
+sip_retention_keeps(const char *ctype, int len);
+
+/**
+ * @brief Get multipart delimiter from Content-Type header parameters
+ *
+ * @param ctype Content-Type header parameters start
+ * @param end End of Content-Type header line
+ * @param boundary Buffer to store the delimiter (boundary prefixed with --)
+ * @param size Delimiter buffer size
+ * @return 1 if boundary parameter was found, 0 otherwise
+ */
+int
+sip_retention_boundary(const char *ctype, const char *end, char *boundary, size_t size);
+
+/**
+ * @brief Check if a multipart body part has a kept content type
+ *
+ * @param part Body part start (its headers)
+ * @param end Body part end
+ * @return 1 if body part must be stored, 0 otherwise
+ */
+int
+sip_retention_keeps_part(const char *part, const char *end);
+
+/**
+ * @brief Apply retention policy to a multipart body
+ *
+ * Content of body parts without kept content types is removed from the
+ * packet payload, keeping their headers. Parts with kept content types
+ * are stored complete. Body parts may contain binary data.
+ *
+ * @param packet SIP packet with a multipart body
+ * @param offset Body offset in packet payload
+ * @param minlen Payload bytes that are always stored
+ * @param boundary Delimiter string (boundary prefixed with --)
+ * @return payload length to be stored after the last kept part
+ */
+uint32_t
+sip_retention_multipart(packet_t *packet, uint32_t offset, uint32_t minlen, const char *boundary);
+
+/**
+ * @brief Apply payload retention policy to a stored SIP packet
+ *
+ * Message headers are always kept. Bodies with a content type in the
+ * keep list (or its parts in multipart bodies) are also kept, the rest
+ * of the body is truncated or dropped when it exceeds the configured
+ * max body size.
+ *
+ * @note This function must be invoked after packet has been parsed,
+ * sent through EEP and written to the output file, as retention only
+ * limits the data stored in memory.
+ *
+ * @param packet Captured packet structure
+ */
+void
+sip_apply_retention(packet_t *packet);
+
 /**
  * @brief Remove al calls
  *
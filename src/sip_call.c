@@ -59,6 +59,11 @@ call_create(char *callid, char *xcallid)
     // Create an empty vector to store x-calls
     call->xcalls = vector_create(0, 1);
 
+    // Create an empty index of media endpoints
+    call->endpoints = vector_create(0, 2);
+    vector_set_destroyer(call->endpoints, call_endpoint_destroyer);
+    call->endpointidx = htable_create(CALL_ENDPOINTS_HASH_SIZE);
+
     // Initialize call filter status
     call->filtered = -1;
 
@@ -80,6 +85,9 @@ call_destroy(sip_call_t *call)
     vector_destroy(call->rtp_packets);
     // Remove all xcalls
     vector_destroy(call->xcalls);
+    // Remove media endpoints index
+    htable_destroy(call->endpointidx);
+    vector_destroy(call->endpoints);
     // Deallocate call memory
     sng_free(call->callid);
     sng_free(call->xcallid);
@@ -113,12 +121,69 @@ call_add_message(sip_call_t *call, sip_msg_t *msg)
 void
 call_add_stream(sip_call_t *call, rtp_stream_t *stream)
 {
+    sip_call_endpoint_t *endpoint;
+
     // Store stream
     vector_append(call->streams, stream);
+    // Index stream by its destination
+    if ((endpoint = call_add_endpoint(call, stream->dst)))
+        vector_append(endpoint->streams, stream);
     // Flag this call as changed
     call->changed = true;
 }
 
+void
+call_add_media(sip_call_t *call, sdp_media_t *media)
+{
+    sip_call_endpoint_t *endpoint;
+
+    if (!(endpoint = call_add_endpoint(call, media->address)))
+        return;
+
+    // Keep the first message announcing this address
+    if (!endpoint->msg) {
+        endpoint->msg = media->msg;
+        endpoint->media = media;
+    }
+}
+
+sip_call_endpoint_t *
+call_find_endpoint(sip_call_t *call, address_t addr)
+{
+    char key[ADDRESSLEN + 7];
+    snprintf(key, sizeof(key), "%s:%hu", addr.ip, addr.port);
+    return htable_find(call->endpointidx, key);
+}
+
+sip_call_endpoint_t *
+call_add_endpoint(sip_call_t *call, address_t addr)
+{
+    sip_call_endpoint_t *endpoint;
+
+    // Check if this address is already indexed
+    if ((endpoint = call_find_endpoint(call, addr)))
+        return endpoint;
+
+    // Create a new endpoint for this address
+    if (!(endpoint = sng_malloc(sizeof(sip_call_endpoint_t))))
+        return NULL;
+
+    snprintf(endpoint->key, sizeof(endpoint->key), "%s:%hu", addr.ip, addr.port);
+    endpoint->streams = vector_create(0, 2);
+    vector_append(call->endpoints, endpoint);
+    htable_insert(call->endpointidx, endpoint->key, endpoint);
+    return endpoint;
+}
+
+void
+call_endpoint_destroyer(void *item)
+{
+    sip_call_endpoint_t *endpoint = (sip_call_endpoint_t *) item;
+    // Streams are owned by the call
+    vector_destroy(endpoint->streams);
+    sng_free(endpoint);
+}
+
 void
 call_add_rtp_packet(sip_call_t *call, packet_t *packet)
 {
@@ -155,6 +220,7 @@ call_msg_retrans_check(sip_msg_t *msg)
 {
     sip_msg_t *prev = NULL;
     vector_iter_t it;
+    const char *body;
 
     // Get previous message in call with same origin and destination
     it = vector_iterator(msg->call->msgs);
@@ -165,8 +231,18 @@ call_msg_retrans_check(sip_msg_t *msg)
             break;
     }
 
+    if (!prev)
+        return;
+
     // Store the flag that determines if message is retrans
-    if (prev && !strcasecmp(msg_get_payload(msg), msg_get_payload(prev))) {
+    if (prev->packet->payload_trunc) {
+        // Previous message body has been limited by retention policy, compare headers
+        if (packet_payloadlen(msg->packet) == packet_payloadlen(prev->packet) + prev->packet->payload_trunc
+            && (body = strstr(msg_get_payload(prev), "\r\n\r\n"))
+            && !strncasecmp(msg_get_payload(msg), msg_get_payload(prev), body - msg_get_payload(prev))) {
+            msg->retrans = prev;
+        }
+    } else if (!strcasecmp(msg_get_payload(msg), msg_get_payload(prev))) {
         msg->retrans = prev;
     }
 }
@@ -174,21 +250,11 @@ call_msg_retrans_check(sip_msg_t *msg)
 sip_msg_t *
 call_msg_with_media(sip_call_t *call, address_t dst)
 {
-    sip_msg_t *msg;
-    sdp_media_t *media;
-    vector_iter_t itmsg;
-    vector_iter_t itmedia;
+    sip_call_endpoint_t *endpoint;
 
     // Get message with media address configured in given dst
-    itmsg = vector_iterator(call->msgs);
-    while ((msg = vector_iterator_next(&itmsg))) {
-        itmedia = vector_iterator(msg->medias);
-        while ((media = vector_iterator_next(&itmedia))) {
-            if (addressport_equals(dst, media->address)) {
-                return msg;
-            }
-        }
-    }
+    if ((endpoint = call_find_endpoint(call, dst)))
+        return endpoint->msg;
 
     return NULL;
 }
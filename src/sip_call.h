@@ -33,12 +33,18 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include "vector.h"
+#include "hash.h"
 #include "rtp.h"
 #include "sip_msg.h"
 #include "sip_attr.h"
 
 //! Shorter declaration of sip_call structure
 typedef struct sip_call sip_call_t;
+//! Shorter declaration of call media endpoint structure
+typedef struct sip_call_endpoint sip_call_endpoint_t;
+
+//! Number of buckets of each call media endpoint index
+#define CALL_ENDPOINTS_HASH_SIZE 16
 
 //! SIP Call State
 enum call_state
@@ -52,6 +58,24 @@ enum call_state
     SIP_CALLSTATE_COMPLETED
 };
 
+/**
+ * @brief Media endpoint (ip:port) of a call
+ *
+ * Each call keeps an index of the media addresses announced in its
+ * messages SDP and the streams sent to them, so RTP and message lookups
+ * don't need to walk all call messages and streams.
+ */
+struct sip_call_endpoint {
+    //! Endpoint address in ip:port format (index key)
+    char key[ADDRESSLEN + 7];
+    //! First message announcing media in this address
+    sip_msg_t *msg;
+    //! Media of the first message announcing this address
+    sdp_media_t *media;
+    //! Streams with this address as destination (rtp_stream_t *)
+    vector_t *streams;
+};
+
 /**
  * @brief Contains all information of a call and its messages
  *
@@ -90,6 +114,10 @@ struct sip_call {
     vector_t *streams;
     //! RTP packets for this call (capture_packet_t *)
     vector_t *rtp_packets;
+    //! Media endpoints of this call (sip_call_endpoint_t *)
+    vector_t *endpoints;
+    //! Media endpoints indexed by ip:port
+    htable_t *endpointidx;
 };
 
 /**
@@ -159,6 +187,44 @@ call_add_message(sip_call_t *call, sip_msg_t *msg);
 void
 call_add_stream(sip_call_t *call, rtp_stream_t *stream);
 
+/**
+ * @brief Register a message media address in the call endpoints
+ *
+ * Only the first message announcing each address is stored, as
+ * that's the one that will be used for RTP attribution.
+ *
+ * @param call pointer to the call owner of the media
+ * @param media SDP media already parsed
+ */
+void
+call_add_media(sip_call_t *call, sdp_media_t *media);
+
+/**
+ * @brief Get the call endpoint information of given address
+ *
+ * @param call pointer to the call to search in
+ * @param addr Address and port of the endpoint
+ * @return endpoint information or NULL if not found
+ */
+sip_call_endpoint_t *
+call_find_endpoint(sip_call_t *call, address_t addr);
+
+/**
+ * @brief Get or create the call endpoint information of given address
+ *
+ * @param call pointer to the call owner of the endpoint
+ * @param addr Address and port of the endpoint
+ * @return endpoint information or NULL on allocation error
+ */
+sip_call_endpoint_t *
+call_add_endpoint(sip_call_t *call, address_t addr);
+
+/**
+ * @brief Wrapper around endpoint destroyer to clear call vectors
+ */
+void
+call_endpoint_destroyer(void *endpoint);
+
 /**
  * @brief Append a new RTP packet to the call
  *
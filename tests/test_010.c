@@ -100,5 +100,29 @@ int main ()
     // Destroy the table
     htable_destroy(table);
 
+    // Single bucket table: all entries share the same chain
+    table = htable_create(1);
+    htable_insert(table, "key1", "data1");
+    htable_insert(table, "key2", "data2");
+    htable_insert(table, "key3", "data3");
+    htable_insert(table, "key4", "data4");
+
+    // Remove entries in the middle, start and end of the chain
+    htable_remove(table, "key2");
+    assert(htable_find(table, "key2") == NULL);
+    htable_remove(table, "key4");
+    assert(htable_find(table, "key4") == NULL);
+    htable_remove(table, "key1");
+    assert(htable_find(table, "key1") == NULL);
+    assert(strcmp(htable_find(table, "key3"), "data3") == 0);
+
+    // Removing a not found entry keeps the chain
+    htable_remove(table, "key5");
+    assert(strcmp(htable_find(table, "key3"), "data3") == 0);
+
+    // Destroy the table with stored entries
+    htable_insert(table, "key6", "data6");
+    htable_destroy(table);
+
     return 0;
 }
@@ -0,0 +1,88 @@
+/**************************************************************************
+ **
+ ** sngrep - SIP Messages flow viewer
+ **
+ ** Copyright (C) 2013-2018 Ivan Alonso (Kaian)
+ ** Copyright (C) 2013-2018 Irontec SL. All rights reserved.
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ ****************************************************************************/
+/**
+ * @file test_011.c
+ * @author Ivan Alonso [aka Kaian] <kaian@irontec.com>
+ *
+ * Basic testing of settings typed values
+ */
+
+#include "config.h"
+#include <assert.h>
+#include <string.h>
+#include "setting.h"
+
+int changes = 0;
+
+void
+test_setting_changed(int id, void *data)
+{
+    assert(id == SETTING_CF_MEDIA);
+    assert(data == &changes);
+    changes++;
+}
+
+int main ()
+{
+    unsigned int gen;
+
+    settings_init();
+
+    // Check default values are parsed
+    assert(setting_get_enum(SETTING_CF_SDP_INFO) == SETTING_SDP_OFF);
+    assert(setting_get_enum(SETTING_CF_MEDIA) == SETTING_MEDIA_OFF);
+    assert(setting_get_intvalue(SETTING_CAPTURE_LIMIT) == 20000);
+    assert(setting_get_intvalue(SETTING_CF_RAWFIXEDWIDTH) == -1);
+    assert(setting_enabled(SETTING_SYNTAX));
+    assert(setting_disabled(SETTING_CF_MEDIA));
+
+    // Check typed values follow setting changes
+    setting_set_value(SETTING_CF_SDP_INFO, "compressed");
+    assert(setting_get_enum(SETTING_CF_SDP_INFO) == SETTING_SDP_COMPRESSED);
+    setting_set_intvalue(SETTING_CAPTURE_LIMIT, 100);
+    assert(setting_get_intvalue(SETTING_CAPTURE_LIMIT) == 100);
+    setting_set_value(SETTING_CF_SDP_INFO, "invalid");
+    assert(setting_get_enum(SETTING_CF_SDP_INFO) == -1);
+
+    // Check callbacks are only invoked on real changes
+    assert(setting_add_callback(SETTING_CF_MEDIA, test_setting_changed, &changes) == 0);
+    gen = setting_generation(SETTING_CF_MEDIA);
+    setting_set_value(SETTING_CF_MEDIA, SETTING_OFF);
+    assert(changes == 0);
+    assert(setting_generation(SETTING_CF_MEDIA) == gen);
+
+    // Active is neither enabled nor disabled
+    setting_set_value(SETTING_CF_MEDIA, SETTING_ACTIVE);
+    assert(changes == 1);
+    assert(setting_generation(SETTING_CF_MEDIA) > gen);
+    assert(setting_generation(-1) == setting_generation(SETTING_CF_MEDIA));
+    assert(setting_get_enum(SETTING_CF_MEDIA) == SETTING_MEDIA_ACTIVE);
+    assert(!setting_enabled(SETTING_CF_MEDIA));
+    assert(!setting_disabled(SETTING_CF_MEDIA));
+
+    // Toggle to next enum value
+    setting_toggle(SETTING_CF_MEDIA);
+    assert(changes == 2);
+    assert(setting_get_enum(SETTING_CF_MEDIA) == SETTING_MEDIA_OFF);
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**************************************************************************
+ **
+ ** sngrep - SIP Messages flow viewer
+ **
+ ** Copyright (C) 2013-2018 Ivan Alonso (Kaian)
+ ** Copyright (C) 2013-2018 Irontec SL. All rights reserved.
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ ****************************************************************************/
+/**
+ * @file test_012.c
+ * @author Ivan Alonso [aka Kaian] <kaian@irontec.com>
+ *
+ * Basic testing of packet payload truncation
+ */
+
+#include "config.h"
+#include <assert.h>
+#include <string.h>
+#include "packet.h"
+
+int main ()
+{
+    packet_t *packet;
+    frame_t *frame;
+    address_t src = { "127.0.0.1", 5060 }, dst = { "127.0.0.1", 5061 };
+    struct pcap_pkthdr header = { };
+    const char *payload = "NOTIFY sip:alice@127.0.0.1 SIP/2.0\r\n\r\n<presence/>";
+
+    // Create a single frame UDP packet
+    header.caplen = header.len = strlen(payload);
+    packet = packet_create(4, 17, src, dst, 0);
+    packet_add_frame(packet, &header, (const u_char *) payload);
+    packet_set_type(packet, PACKET_SIP_UDP);
+    packet_set_payload(packet, (u_char *) payload, strlen(payload));
+    assert(packet->payload_trunc == 0);
+
+    // Truncating to a bigger size does nothing
+    packet_truncate_payload(packet, strlen(payload) + 10);
+    assert(packet_payloadlen(packet) == strlen(payload));
+
+    // Remove message body
+    packet_truncate_payload(packet, strlen(payload) - 11);
+    assert(packet_payloadlen(packet) == strlen(payload) - 11);
+    assert(packet->payload_trunc == 11);
+    assert(strcmp((const char *) packet_payload(packet), "NOTIFY sip:alice@127.0.0.1 SIP/2.0\r\n\r\n") == 0);
+
+    // Frame keeps its original length
+    frame = vector_first(packet->frames);
+    assert(frame->header->caplen == strlen(payload) - 11);
+    assert(frame->header->len == strlen(payload));
+
+    packet_destroy(packet);
+
+    // Create a TCP packet with two segments (14 bytes of headers each)
+    u_char segment[64];
+    memset(segment, 0, sizeof(segment));
+    packet = packet_create(4, 6, src, dst, 0);
+    header.caplen = header.len = 14 + 30;
+    frame = packet_add_frame(packet, &header, segment);
+    frame->payload_hl = 14;
+    frame->payload_len = 30;
+    header.caplen = header.len = 14 + 20;
+    frame = packet_add_frame(packet, &header, segment);
+    frame->payload_hl = 14;
+    frame->payload_len = 20;
+    packet_shift_frames(packet, 1, 30);
+    packet_set_type(packet, PACKET_SIP_TCP);
+    packet_set_payload(packet, segment, 50);
+
+    // Truncate in the middle of the first segment
+    packet_truncate_payload(packet, 25);
+    assert(packet->payload_trunc == 25);
+    frame = vector_item(packet->frames, 0);
+    assert(frame->header->caplen == 14 + 25);
+    assert(frame->header->len == 14 + 30);
+    // Second segment only keeps its headers
+    frame = vector_item(packet->frames, 1);
+    assert(frame->header->caplen == 14);
+    assert(frame->header->len == 14 + 20);
+    packet_destroy(packet);
+
+    // Remove a range in the middle of the payload
+    header.caplen = header.len = strlen(payload);
+    packet = packet_create(4, 17, src, dst, 0);
+    packet_add_frame(packet, &header, (const u_char *) payload);
+    packet_set_type(packet, PACKET_SIP_UDP);
+    packet_set_payload(packet, (u_char *) payload, strlen(payload));
+    packet_strip_payload(packet, strlen(payload) - 11, 10);
+    assert(packet_payloadlen(packet) == strlen(payload) - 10);
+    assert(packet->payload_trunc == 10);
+    assert(strcmp((const char *) packet_payload(packet), "NOTIFY sip:alice@127.0.0.1 SIP/2.0\r\n\r\n>") == 0);
+    // Frame data can not contain a gap
+    frame = vector_first(packet->frames);
+    assert(frame->header->caplen == strlen(payload) - 11);
+    assert(frame->header->len == strlen(payload));
+    packet_destroy(packet);
+
+    return 0;
+}
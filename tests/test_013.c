@@ -0,0 +1,174 @@
+/**************************************************************************
+ **
+ ** sngrep - SIP Messages flow viewer
+ **
+ ** Copyright (C) 2013-2018 Ivan Alonso (Kaian)
+ ** Copyright (C) 2013-2018 Irontec SL. All rights reserved.
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ ****************************************************************************/
+/**
+ * @file test_013.c
+ * @author Ivan Alonso [aka Kaian] <kaian@irontec.com>
+ *
+ * Basic testing of HEPv3 chunk parsing and quality report values
+ */
+
+#include "config.h"
+#include <assert.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include "hep.h"
+
+int
+add_chunk(u_char *buffer, int pos, uint16_t type, const void *data, uint16_t len)
+{
+    uint16_t vendor = 0, ntype = htons(type), nlen = htons(len + 6);
+
+    memcpy(buffer + pos, &vendor, 2);
+    memcpy(buffer + pos + 2, &ntype, 2);
+    memcpy(buffer + pos + 4, &nlen, 2);
+    memcpy(buffer + pos + 6, data, len);
+    return pos + len + 6;
+}
+
+int
+set_header(u_char *buffer, int len)
+{
+    uint16_t nlen = htons(len);
+
+    memcpy(buffer, "HEP3", 4);
+    memcpy(buffer + 4, &nlen, 2);
+    return len;
+}
+
+int main ()
+{
+    hep_info_t info;
+    u_char buffer[512];
+    const char *payload = "OPTIONS sip:bob@127.0.0.1 SIP/2.0\r\n\r\n";
+    const char *callid = "1234@127.0.0.1";
+    uint8_t family = AF_INET, proto_type = 0x05, short_data = 0;
+    uint16_t port = htons(5060);
+    uint32_t ip4 = htonl(0x7F000001), sec = htonl(1500000000);
+    u_char ip6[16] = { [15] = 1 };
+    char key[150];
+    double value;
+    int pos;
+
+    // Chunks in any order
+    pos = add_chunk(buffer, 6, HEP_CHUNK_PAYLOAD, payload, strlen(payload));
+    pos = add_chunk(buffer, pos, HEP_CHUNK_CORRELATION_ID, callid, strlen(callid));
+    pos = add_chunk(buffer, pos, HEP_CHUNK_DST_PORT, &port, 2);
+    pos = add_chunk(buffer, pos, HEP_CHUNK_IP4_SRC, &ip4, 4);
+    pos = add_chunk(buffer, pos, HEP_CHUNK_TIME_SEC, &sec, 4);
+    pos = add_chunk(buffer, pos, HEP_CHUNK_PROTO_TYPE, &proto_type, 1);
+    pos = add_chunk(buffer, pos, HEP_CHUNK_IP_FAMILY, &family, 1);
+    set_header(buffer, pos);
+    assert(hep_parse_v3(buffer, pos, NULL, &info) == 0);
+    assert(info.family == AF_INET);
+    assert(info.proto_type == HEP_PROTO_RTCP);
+    assert(strcmp(info.src.ip, "127.0.0.1") == 0);
+    assert(info.dst.port == 5060);
+    assert(info.ts.tv_sec == 1500000000);
+    assert(info.payload_len == strlen(payload));
+    assert(memcmp(info.payload, payload, info.payload_len) == 0);
+    assert(strcmp(info.callid, callid) == 0);
+
+    // Short fixed size chunks are ignored
+    pos = add_chunk(buffer, 6, HEP_CHUNK_PAYLOAD, payload, strlen(payload));
+    pos = add_chunk(buffer, pos, HEP_CHUNK_IP4_SRC, &ip4, 4);
+    pos = add_chunk(buffer, pos, HEP_CHUNK_SRC_PORT, &short_data, 1);
+    pos = add_chunk(buffer, pos, HEP_CHUNK_TIME_USEC, &short_data, 1);
+    pos = add_chunk(buffer, pos, HEP_CHUNK_IP4_DST, &short_data, 1);
+    set_header(buffer, pos);
+    assert(hep_parse_v3(buffer, pos, NULL, &info) == 0);
+    assert(info.src.port == 0);
+    assert(info.ts.tv_usec == 0);
+    assert(strlen(info.dst.ip) == 0);
+
+    // Chunk exceeding received data
+    assert(hep_parse_v3(buffer, pos - 1, NULL, &info) != 0);
+
+    // IP family is taken from address chunks
+    family = AF_INET6;
+    pos = add_chunk(buffer, 6, HEP_CHUNK_PAYLOAD, payload, strlen(payload));
+    pos = add_chunk(buffer, pos, HEP_CHUNK_IP_FAMILY, &family, 1);
+    set_header(buffer, pos);
+    assert(hep_parse_v3(buffer, pos, NULL, &info) != 0);
+    pos = add_chunk(buffer, pos, HEP_CHUNK_IP4_DST, &ip4, 4);
+    set_header(buffer, pos);
+    assert(hep_parse_v3(buffer, pos, NULL, &info) == 0);
+    assert(info.family == AF_INET);
+#ifdef USE_IPV6
+    // Mixed address families
+    pos = add_chunk(buffer, pos, HEP_CHUNK_IP6_SRC, ip6, 16);
+    set_header(buffer, pos);
+    assert(hep_parse_v3(buffer, pos, NULL, &info) != 0);
+    pos = add_chunk(buffer, 6, HEP_CHUNK_PAYLOAD, payload, strlen(payload));
+    pos = add_chunk(buffer, pos, HEP_CHUNK_IP6_SRC, ip6, 16);
+    set_header(buffer, pos);
+    assert(hep_parse_v3(buffer, pos, NULL, &info) == 0);
+    assert(info.family == AF_INET6);
+    assert(strcmp(info.src.ip, "::1") == 0);
+#endif
+
+    // Packet without payload
+    pos = add_chunk(buffer, 6, HEP_CHUNK_IP_FAMILY, &family, 1);
+    set_header(buffer, pos);
+    assert(hep_parse_v3(buffer, pos, NULL, &info) != 0);
+
+    // Missing auth chunk
+    pos = add_chunk(buffer, 6, HEP_CHUNK_PAYLOAD, payload, strlen(payload));
+    pos = add_chunk(buffer, pos, HEP_CHUNK_IP4_SRC, &ip4, 4);
+    set_header(buffer, pos);
+    assert(hep_parse_v3(buffer, pos, "secret", &info) != 0);
+
+    // Invalid and valid auth chunk
+    pos = add_chunk(buffer, pos, HEP_CHUNK_AUTH_KEY, "wrong", 5);
+    set_header(buffer, pos);
+    assert(hep_parse_v3(buffer, pos, "secret", &info) != 0);
+    pos = add_chunk(buffer, 6, HEP_CHUNK_PAYLOAD, payload, strlen(payload));
+    pos = add_chunk(buffer, pos, HEP_CHUNK_IP4_SRC, &ip4, 4);
+    pos = add_chunk(buffer, pos, HEP_CHUNK_AUTH_KEY, "secret", 6);
+    set_header(buffer, pos);
+    assert(hep_parse_v3(buffer, pos, "secret", &info) == 0);
+
+    // Any auth chunk is accepted without password
+    memset(key, 'k', sizeof(key));
+    pos = add_chunk(buffer, 6, HEP_CHUNK_PAYLOAD, payload, strlen(payload));
+    pos = add_chunk(buffer, pos, HEP_CHUNK_IP4_SRC, &ip4, 4);
+    pos = add_chunk(buffer, pos, HEP_CHUNK_AUTH_KEY, key, sizeof(key));
+    set_header(buffer, pos);
+    assert(hep_parse_v3(buffer, pos, NULL, &info) == 0);
+    assert(hep_parse_v3(buffer, pos, "secret", &info) != 0);
+
+    // JSON RTCP report keys
+    const char *json = "{\"sender_information\":{\"packets\":1500,\"octets\":240000},"
+                       "\"report_blocks\":[{\"fraction_lost\":12,\"packets_lost\":34,\"ia_jitter\":56}]}";
+    assert(hep_report_value(json, "packets", &value) == 0 && value == 1500);
+    assert(hep_report_value(json, "fraction_lost", &value) == 0 && value == 12);
+    assert(hep_report_value(json, "packets_lost", &value) == 0 && value == 34);
+    assert(hep_report_value(json, "ia_jitter", &value) == 0 && value == 56);
+    assert(hep_report_value(json, "jitter", &value) != 0);
+
+    // Key=value RTCP-XR VQ report
+    const char *vq = "VQSessionReport: CallTerm\r\nQualityEst:MOSLQ=4.1 MOSCQ=3.9\r\n";
+    assert(hep_report_value(vq, "moslq", &value) == 0 && value == 4.1);
+    assert(hep_report_value(vq, "moscq", &value) == 0 && value == 3.9);
+    assert(hep_report_value(vq, "mos", &value) != 0);
+
+    return 0;
+}
@@ -0,0 +1,227 @@
+/**************************************************************************
+ **
+ ** sngrep - SIP Messages flow viewer
+ **
+ ** Copyright (C) 2013-2018 Ivan Alonso (Kaian)
+ ** Copyright (C) 2013-2018 Irontec SL. All rights reserved.
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ ****************************************************************************/
+/**
+ * @file test_014.c
+ * @author Ivan Alonso [aka Kaian] <kaian@irontec.com>
+ *
+ * Basic testing of SIP payload retention policy
+ */
+
+#include "config.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "sip.h"
+#include "setting.h"
+#include "capture.h"
+#include "filter.h"
+
+// Capture and filter functions used by SIP parsing
+void
+capture_lock()
+{
+}
+
+void
+capture_unlock()
+{
+}
+
+int
+filter_check_call(void *item)
+{
+    return 1;
+}
+
+const char *headers =
+    "NOTIFY sip:alice@127.0.0.1 SIP/2.0\r\n"
+    "Call-ID: retention@127.0.0.1\r\n"
+    "CSeq: 1 NOTIFY\r\n";
+
+// Create a single frame UDP packet with given payload
+packet_t *
+test_packet(const char *payload, uint32_t len)
+{
+    packet_t *packet;
+    address_t src = { "127.0.0.1", 5060 }, dst = { "127.0.0.1", 5061 };
+    struct pcap_pkthdr header = { };
+
+    header.caplen = header.len = len;
+    packet = packet_create(4, 17, src, dst, 0);
+    packet_add_frame(packet, &header, (const u_char *) payload);
+    packet_set_type(packet, PACKET_SIP_UDP);
+    packet_set_payload(packet, (u_char *) payload, len);
+    return packet;
+}
+
+// Create a SIP packet with given first lines (default NOTIFY headers) and body
+packet_t *
+test_message(const char *first, const char *ctype, const char *body, uint32_t bodylen)
+{
+    static char payload[2048];
+    uint32_t len;
+
+    len = sprintf(payload, "%sContent-Type: %s\r\n\r\n", first ? first : headers, ctype);
+    memcpy(payload + len, body, bodylen);
+    return test_packet(payload, len + bodylen);
+}
+
+int main ()
+{
+    sip_retention_t retention;
+    packet_t *packet;
+    sip_msg_t *msg;
+    frame_t *frame;
+    char body[100];
+    const char *payload;
+    uint32_t len;
+
+    // Binary multipart body (ISUP part contains 0x00 and a false delimiter)
+    const char multipart[] =
+        "--xyz\r\n"
+        "Content-Type: application/isup\r\n"
+        "\r\n"
+        "\x01\x00\x02\r\n--xy\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d\x0e\x0f\x10\x11\x12\x13\x14\x15\x16\x17\x18\x19\r\n"
+        "--xyz\r\n"
+        "Content-Type: application/sdp\r\n"
+        "\r\n"
+        "v=0\r\n"
+        "\r\n"
+        "--xyz--\r\n";
+
+    settings_init();
+    sip_init(100, 0, 0);
+    memset(body, 'a', sizeof(body));
+
+    // Retention disabled by default
+    packet = test_message(NULL, "text/plain", body, sizeof(body));
+    sip_apply_retention(packet);
+    assert(packet->payload_trunc == 0);
+    packet_destroy(packet);
+
+    // Drop mode removes the whole body
+    setting_set_value(SETTING_SIP_RETENTION, "drop");
+    setting_set_intvalue(SETTING_SIP_RETENTION_MAXBODY, 10);
+    setting_set_value(SETTING_SIP_RETENTION_KEEP, "application/sdp");
+    packet = test_message(NULL, "text/plain", body, sizeof(body));
+    sip_apply_retention(packet);
+    assert(packet->payload_trunc == sizeof(body));
+    payload = (const char *) packet_payload(packet);
+    assert(!strcmp(payload + packet_payloadlen(packet) - 4, "\r\n\r\n"));
+    // Frame is also truncated, keeping its original length
+    frame = vector_first(packet->frames);
+    assert(frame->header->caplen == packet_payloadlen(packet));
+    assert(frame->header->len == packet_payloadlen(packet) + sizeof(body));
+    packet_destroy(packet);
+
+    // Bodies not bigger than maxbody are stored
+    packet = test_message(NULL, "text/plain", body, 10);
+    sip_apply_retention(packet);
+    assert(packet->payload_trunc == 0);
+    packet_destroy(packet);
+
+    // Kept content types are stored (case insensitive)
+    packet = test_message(NULL, "Application/SDP", body, sizeof(body));
+    sip_apply_retention(packet);
+    assert(packet->payload_trunc == 0);
+    packet_destroy(packet);
+
+    // Truncate mode stores the first maxbody bytes
+    setting_set_value(SETTING_SIP_RETENTION, "truncate");
+    packet = test_message(NULL, "text/plain", body, sizeof(body));
+    sip_apply_retention(packet);
+    assert(packet->payload_trunc == sizeof(body) - 10);
+    payload = (const char *) packet_payload(packet);
+    assert(!strcmp(payload + packet_payloadlen(packet) - 14, "\r\n\r\naaaaaaaaaa"));
+    packet_destroy(packet);
+
+    // Multipart parts with kept content types are stored, even after binary parts
+    setting_set_value(SETTING_SIP_RETENTION, "drop");
+    packet = test_message(NULL, "multipart/mixed;boundary=\"xyz\"", multipart, sizeof(multipart) - 1);
+    sip_apply_retention(packet);
+    payload = (const char *) packet_payload(packet);
+    len = packet_payloadlen(packet);
+    // ISUP part content is removed, keeping its headers
+    assert(packet->payload_trunc == 32 + strlen("\r\n--xyz--\r\n"));
+    assert(memmem(payload, len, "application/isup\r\n\r\n\r\n--xyz\r\n", 29));
+    assert(!memchr(payload, 0, len));
+    // Frame data is stored until the removed part content
+    frame = vector_first(packet->frames);
+    assert(frame->header->caplen == (const char *) memmem(payload, len, "application/isup", 16) - payload + 20);
+    // SDP part is complete
+    assert(!strcmp(payload + len - 24, "application/sdp\r\n\r\nv=0\r\n"));
+    packet_destroy(packet);
+
+    // Without boundary parameter multipart is handled as any other body
+    packet = test_message(NULL, "multipart/mixed", multipart, sizeof(multipart) - 1);
+    sip_apply_retention(packet);
+    assert(packet->payload_trunc == sizeof(multipart) - 1);
+    packet_destroy(packet);
+
+    // Methods are matched case insensitively
+    setting_set_value(SETTING_SIP_RETENTION_METHODS, "invite, notify");
+    assert(sip_retention_load(&retention) == 0);
+    assert(retention.methods_set);
+    assert(retention.methods == ((1 << SIP_METHOD_INVITE) | (1 << SIP_METHOD_NOTIFY)));
+    packet = test_message(NULL, "text/plain", body, sizeof(body));
+    sip_apply_retention(packet);
+    assert(packet->payload_trunc == sizeof(body));
+    packet_destroy(packet);
+
+    // Other methods and responses are not limited when methods are configured
+    packet = test_message("MESSAGE sip:alice@127.0.0.1 SIP/2.0\r\n", "text/plain", body, sizeof(body));
+    sip_apply_retention(packet);
+    assert(packet->payload_trunc == 0);
+    packet_destroy(packet);
+    packet = test_message("SIP/2.0 200 OK\r\n", "text/plain", body, sizeof(body));
+    sip_apply_retention(packet);
+    assert(packet->payload_trunc == 0);
+    packet_destroy(packet);
+
+    // Unknown methods never apply the policy to all messages
+    setting_set_value(SETTING_SIP_RETENTION_METHODS, "FOO");
+    assert(sip_retention_load(&retention) == 1);
+    assert(retention.methods_set && retention.methods == 0);
+    packet = test_message(NULL, "text/plain", body, sizeof(body));
+    sip_apply_retention(packet);
+    assert(packet->payload_trunc == 0);
+    packet_destroy(packet);
+
+    // Retransmissions of truncated messages are detected
+    setting_set_value(SETTING_SIP_RETENTION_METHODS, "");
+    packet = test_message(NULL, "text/plain", body, sizeof(body));
+    assert(sip_check_packet(packet));
+    sip_apply_retention(packet);
+    assert(packet->payload_trunc == sizeof(body));
+    packet = test_message(NULL, "text/plain", body, sizeof(body));
+    assert((msg = sip_check_packet(packet)));
+    assert(msg->retrans);
+    sip_apply_retention(packet);
+
+    // Messages with a different length are not retransmissions
+    packet = test_message(NULL, "text/plain", body, sizeof(body) - 1);
+    assert((msg = sip_check_packet(packet)));
+    assert(!msg->retrans);
+
+    sip_deinit();
+    return 0;
+}
@@ -0,0 +1,129 @@
+/**************************************************************************
+ **
+ ** sngrep - SIP Messages flow viewer
+ **
+ ** Copyright (C) 2013-2018 Ivan Alonso (Kaian)
+ ** Copyright (C) 2013-2018 Irontec SL. All rights reserved.
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ ****************************************************************************/
+/**
+ * @file test_015.c
+ * @author Ivan Alonso [aka Kaian] <kaian@irontec.com>
+ *
+ * Basic testing of call media endpoints index
+ */
+
+#include "config.h"
+#include <assert.h>
+#include <string.h>
+#include "sip.h"
+#include "capture.h"
+#include "filter.h"
+
+// Capture and filter functions used by SIP parsing
+void
+capture_lock()
+{
+}
+
+void
+capture_unlock()
+{
+}
+
+int
+filter_check_call(void *item)
+{
+    return 1;
+}
+
+// Create a call message announcing media in given address
+sip_msg_t *
+test_message(sip_call_t *call, address_t addr)
+{
+    sip_msg_t *msg;
+    sdp_media_t *media;
+
+    msg = msg_create();
+    call_add_message(call, msg);
+    media = media_create(msg);
+    media_set_address(media, addr);
+    msg_add_media(msg, media);
+    call_add_media(call, media);
+    return msg;
+}
+
+int main ()
+{
+    sip_call_t *call;
+    sip_msg_t *msg1, *msg2, *msg3;
+    sip_call_endpoint_t *endpoint;
+    rtp_stream_t *stream1, *stream2;
+    address_t none = { }, addr = { "10.0.0.1", 4000 }, other = { "10.0.0.1", 4001 };
+    address_t src1 = { "10.0.0.2", 5000 }, src2 = { "10.0.0.3", 6000 };
+
+    call = call_create("endpoints@10.0.0.1", "");
+    assert(call);
+
+    // No media has been announced yet
+    assert(call_find_endpoint(call, addr) == NULL);
+    assert(call_msg_with_media(call, addr) == NULL);
+
+    // First message announcing the address is kept
+    msg1 = test_message(call, addr);
+    msg2 = test_message(call, addr);
+    assert(call_msg_with_media(call, addr) == msg1);
+    assert((endpoint = call_find_endpoint(call, addr)));
+    assert(endpoint->msg == msg1);
+    assert(vector_count(call->endpoints) == 1);
+
+    // Endpoints are indexed by address and port
+    assert(call_find_endpoint(call, other) == NULL);
+    assert(call_msg_with_media(call, other) == NULL);
+    msg3 = test_message(call, other);
+    assert(call_msg_with_media(call, other) == msg3);
+    assert(call_msg_with_media(call, addr) == msg1);
+    assert(vector_count(call->endpoints) == 2);
+
+    // Streams are indexed by their destination
+    stream1 = stream_create(vector_first(msg1->medias), addr, PACKET_RTP);
+    call_add_stream(call, stream1);
+    stream2 = stream_create(vector_first(msg2->medias), addr, PACKET_RTP);
+    call_add_stream(call, stream2);
+    assert(vector_count(endpoint->streams) == 2);
+    assert(rtp_find_call_stream(call, src1, other) == NULL);
+
+    // Newest stream is returned first
+    assert(rtp_find_call_stream(call, none, addr) == stream2);
+    assert(rtp_find_call_stream(call, src1, addr) == stream2);
+
+    // Streams with packets are only returned for their source
+    stream_complete(stream2, src2);
+    stream2->pktcnt = 1;
+    assert(rtp_find_call_stream(call, src1, addr) == stream1);
+    stream_complete(stream1, src1);
+    stream1->pktcnt = 1;
+    assert(rtp_find_call_stream(call, src1, addr) == stream1);
+    assert(rtp_find_call_stream(call, src2, addr) == stream2);
+
+    // Newest exact stream is returned first
+    stream_complete(stream1, src2);
+    assert(rtp_find_call_exact_stream(call, src2, addr) == stream2);
+    assert(rtp_find_call_exact_stream(call, src1, addr) == NULL);
+
+    call_destroy(call);
+    return 0;
+}